@@ -0,0 +1,209 @@
+/**
+ * @file Arena.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Arena implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Arena.h"
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_LIST_INITIAL_CAPACITY 16
+
+#define ALIGN_ARENA( size ) ( ( ( size ) + ARENA_ALIGNMENT - 1 ) & ~(size_t) ( ARENA_ALIGNMENT - 1 ) )
+
+// the items of a block start after its header, aligned
+static uint8_t *blockData( ArenaBlock *block ) {
+    return (uint8_t*) block + ALIGN_ARENA( sizeof( ArenaBlock ) );
+}
+
+// appends a block after the current one (the last) and moves to it
+static void addBlock( Arena *arena, size_t size ) {
+
+    ArenaBlock *block = (ArenaBlock*) malloc( ALIGN_ARENA( sizeof( ArenaBlock ) ) + size );
+
+    block->next = NULL;
+    block->size = size;
+
+    if ( arena->current == NULL ) {
+        arena->first = block;
+    } else {
+        arena->current->next = block;
+    }
+
+    arena->current = block;
+    arena->next = blockData( block );
+    arena->end = arena->next + size;
+    arena->capacity += size;
+
+}
+
+static void freeBlocks( Arena *arena ) {
+
+    ArenaBlock *block = arena->first;
+
+    while ( block != NULL ) {
+        ArenaBlock *next = block->next;
+        free( block );
+        block = next;
+    }
+
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->next = NULL;
+    arena->end = NULL;
+    arena->capacity = 0;
+
+}
+
+static void useBlock( Arena *arena, ArenaBlock *block ) {
+    arena->current = block;
+    arena->next = block != NULL ? blockData( block ) : NULL;
+    arena->end = block != NULL ? arena->next + block->size : NULL;
+}
+
+/**
+ * @brief Creates a dinamically allocated empty arena that grows in
+ * blocks of at least blockSize bytes.
+ */
+Arena* createArena( size_t blockSize ) {
+
+    Arena *arena = (Arena*) calloc( 1, sizeof( Arena ) );
+    arena->blockSize = ALIGN_ARENA( blockSize > 0 ? blockSize : ARENA_ALIGNMENT );
+
+    return arena;
+
+}
+
+/**
+ * @brief Destroys an arena and every block it holds.
+ */
+void destroyArena( Arena *arena ) {
+    if ( arena != NULL ) {
+        freeBlocks( arena );
+        free( arena );
+    }
+}
+
+/**
+ * @brief Returns size bytes of the arena, aligned for any type. The
+ * memory is valid up to the next resetArena.
+ */
+void *allocArena( Arena *arena, size_t size ) {
+
+    size = ALIGN_ARENA( size > 0 ? size : 1 );
+
+    // blocks kept after a rewind are used again before a new one is added;
+    // a new block at least doubles the arena, so a frame that keeps
+    // growing needs only a few of them
+    while ( arena->next == NULL || (size_t) ( arena->end - arena->next ) < size ) {
+        if ( arena->current != NULL && arena->current->next != NULL ) {
+            useBlock( arena, arena->current->next );
+        } else {
+            size_t blockSize = arena->capacity > arena->blockSize ? arena->capacity : arena->blockSize;
+            addBlock( arena, blockSize > size ? blockSize : size );
+        }
+    }
+
+    void *memory = arena->next;
+    arena->next += size;
+    arena->used += size;
+
+    if ( arena->used > arena->highWater ) {
+        arena->highWater = arena->used;
+    }
+
+    return memory;
+
+}
+
+/**
+ * @brief Takes back everything handed out by the arena. The blocks are
+ * kept; if the arena had to grow, they are merged into a single block
+ * of its whole capacity first, so the next frames fit in one block.
+ */
+void resetArena( Arena *arena ) {
+
+    if ( arena->first != NULL && arena->first->next != NULL ) {
+        size_t capacity = arena->capacity;
+        freeBlocks( arena );
+        addBlock( arena, capacity );
+    } else {
+        useBlock( arena, arena->first );
+    }
+
+    arena->used = 0;
+
+}
+
+/**
+ * @brief Returns a mark of how far the arena is used now.
+ */
+ArenaMark markArena( const Arena *arena ) {
+    return (ArenaMark) { arena->current, arena->next, arena->used };
+}
+
+/**
+ * @brief Takes back what the arena handed out after mark was taken,
+ * keeping its blocks for the next allocations. Scratch arrays that are
+ * only needed during a call are given back this way, so a frame arena
+ * does not grow with the number of calls.
+ */
+void rewindArena( Arena *arena, ArenaMark mark ) {
+
+    if ( mark.block == NULL ) {
+        useBlock( arena, arena->first );
+    } else {
+        useBlock( arena, mark.block );
+        arena->next = mark.next;
+    }
+
+    arena->used = mark.used;
+
+}
+
+/**
+ * @brief Initializes an empty list of itemSize bytes items in arena.
+ */
+void initArenaList( ArenaList *list, Arena *arena, size_t itemSize ) {
+    list->arena = arena;
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    list->itemSize = itemSize;
+}
+
+/**
+ * @brief Appends an item to the list, growing it if needed, and returns
+ * where the item must be written.
+ */
+void *pushArenaList( ArenaList *list ) {
+
+    if ( list->count == list->capacity ) {
+        int capacity = list->capacity == 0 ? ARENA_LIST_INITIAL_CAPACITY : list->capacity * 2;
+        void *items = allocArena( list->arena, capacity * list->itemSize );
+        if ( list->count > 0 ) {
+            memcpy( items, list->items, list->count * list->itemSize );
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    return (uint8_t*) list->items + list->count++ * list->itemSize;
+
+}
+
+/**
+ * @brief Empties the list. Its memory goes back to the arena with the
+ * next resetArena.
+ */
+void clearArenaList( ArenaList *list ) {
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file BitBoard.c
+ * @author Prof. Dr. David Buzatto
+ * @brief BitBoard implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdint.h>
+
+#include "BitBoard.h"
+
+#define FIRST_COLUMN 0x0101010101010101ULL
+#define LAST_COLUMN  0x8080808080808080ULL
+
+// moves every bit one column to the left (col - 1), without wrapping rows
+static uint64_t shiftWest( uint64_t b ) {
+    return ( b >> 1 ) & ~LAST_COLUMN;
+}
+
+// moves every bit one column to the right (col + 1), without wrapping rows
+static uint64_t shiftEast( uint64_t b ) {
+    return ( b << 1 ) & ~FIRST_COLUMN;
+}
+
+// moves every bit one row up (row - 1)
+static uint64_t shiftNorth( uint64_t b ) {
+    return b >> BITBOARD_SIZE;
+}
+
+// moves every bit one row down (row + 1)
+static uint64_t shiftSouth( uint64_t b ) {
+    return b << BITBOARD_SIZE;
+}
+
+/**
+ * @brief Returns the bit that represents the cell at ( row, col ).
+ */
+uint64_t cellBitBoard( int row, int col ) {
+    return 1ULL << ( row * BITBOARD_SIZE + col );
+}
+
+/**
+ * @brief Removes every piece from the bitboard.
+ */
+void clearBitBoard( BitBoard *bb ) {
+    for ( int i = 0; i < PIECE_TYPE_COUNT; i++ ) {
+        bb->pieces[i] = 0;
+    }
+}
+
+/**
+ * @brief Stores a piece of the given type at ( row, col ).
+ */
+void setBitBoard( BitBoard *bb, int row, int col, PieceType type ) {
+
+    uint64_t bit = cellBitBoard( row, col );
+
+    for ( int i = 0; i < PIECE_TYPE_COUNT; i++ ) {
+        bb->pieces[i] &= ~bit;
+    }
+
+    bb->pieces[type] |= bit;
+
+}
+
+/**
+ * @brief Loads every cell of a board (of at most BITBOARD_SIZE x
+ * BITBOARD_SIZE cells) into the bitboard.
+ */
+void loadBitBoard( BitBoard *bb, const Board *board ) {
+
+    const uint8_t *cells = board->cells;
+
+    clearBitBoard( bb );
+
+    for ( int i = 0; i < board->height; i++ ) {
+        uint64_t bit = cellBitBoard( i, 0 );
+        for ( int j = 0; j < board->width; j++ ) {
+            bb->pieces[*cells++] |= bit;
+            bit <<= 1;
+        }
+    }
+
+}
+
+/**
+ * @brief Returns the cells of a single piece type mask that belong to a
+ * horizontal or vertical run of three or more pieces.
+ */
+uint64_t findMatchesBitBoard( uint64_t pieces ) {
+
+    // cells that start a run of three to the right / downwards
+    uint64_t w1 = shiftWest( pieces );
+    uint64_t n1 = shiftNorth( pieces );
+    uint64_t h = pieces & w1 & shiftWest( w1 );
+    uint64_t v = pieces & n1 & shiftNorth( n1 );
+
+    // spread each start over the three cells of its run
+    h |= shiftEast( h ) | shiftEast( shiftEast( h ) );
+    v |= shiftSouth( v ) | shiftSouth( shiftSouth( v ) );
+
+    return h | v;
+
+}
+
+/**
+ * @brief Returns the cells, of any piece type, that belong to a horizontal
+ * or vertical run of three or more pieces.
+ */
+uint64_t findAllMatchesBitBoard( const BitBoard *bb ) {
+
+    uint64_t matches = 0;
+
+    // PIECE_NULL cells never match
+    for ( int i = 1; i < PIECE_TYPE_COUNT; i++ ) {
+        matches |= findMatchesBitBoard( bb->pieces[i] );
+    }
+
+    return matches;
+
+}
+
+// grows a set of cells by three cells in every direction: the cells a swap
+// depends on (its own two cells and the patterns around them) are never
+// more than three rows or columns away from its first cell
+static uint64_t grow( uint64_t cells ) {
+    for ( int i = 0; i < 3; i++ ) {
+        cells |= shiftWest( cells ) | shiftEast( cells );
+    }
+    for ( int i = 0; i < 3; i++ ) {
+        cells |= shiftNorth( cells ) | shiftSouth( cells );
+    }
+    return cells;
+}
+
+// computes the swaps that make a match, skipping the piece types without
+// pieces in the reach mask, storing them in the right / down masks
+static void findMovesInRegion( const BitBoard *bb, uint64_t reach, uint64_t *right, uint64_t *down ) {
+
+    uint64_t r = 0;
+    uint64_t d = 0;
+    uint64_t sameRight = 0;
+    uint64_t sameDown = 0;
+
+    for ( int i = 1; i < PIECE_TYPE_COUNT; i++ ) {
+
+        uint64_t b = bb->pieces[i];
+
+        if ( ( b & reach ) == 0 ) {
+            continue;
+        }
+
+        uint64_t e1 = shiftEast( b );   // type at col - 1
+        uint64_t w1 = shiftWest( b );   // type at col + 1
+        uint64_t s1 = shiftSouth( b );  // type at row - 1
+        uint64_t n1 = shiftNorth( b );  // type at row + 1
+
+        uint64_t left2 = e1 & shiftEast( e1 );
+        uint64_t right2 = w1 & shiftWest( w1 );
+        uint64_t up2 = s1 & shiftSouth( s1 );
+        uint64_t down2 = n1 & shiftNorth( n1 );
+        uint64_t middleH = e1 & w1;
+        uint64_t middleV = s1 & n1;
+
+        // target cells completed by a piece of this type arriving from
+        // each side (patterns never use the cell the piece comes from)
+        uint64_t fromLeft = ( right2 | up2 | down2 | middleV ) & e1;
+        uint64_t fromRight = ( left2 | up2 | down2 | middleV ) & w1;
+        uint64_t fromAbove = ( down2 | left2 | right2 | middleH ) & s1;
+        uint64_t fromBelow = ( up2 | left2 | right2 | middleH ) & n1;
+
+        // indexed by the left / upper cell of the swap
+        r |= shiftWest( fromLeft ) | fromRight;
+        d |= shiftNorth( fromAbove ) | fromBelow;
+
+        sameRight |= b & w1;
+        sameDown |= b & n1;
+
+    }
+
+    uint64_t filled = 0;
+    for ( int i = 1; i < PIECE_TYPE_COUNT; i++ ) {
+        filled |= bb->pieces[i];
+    }
+
+    *right = r & ~sameRight & filled & shiftWest( filled );
+    *down = d & ~sameDown & filled & shiftNorth( filled );
+
+}
+
+/**
+ * @brief Finds every swap of a stable board that makes a match, using the
+ * "two in line plus a gap" and "two in line plus a neighbor" patterns of
+ * each piece type.
+ */
+void findMovesBitBoard( const BitBoard *bb, MoveSet *moves ) {
+    findMovesInRegion( bb, ~0ULL, &moves->right, &moves->down );
+}
+
+/**
+ * @brief Refreshes a move set after the cells in changed were modified.
+ * Only swaps close enough to a changed cell to be affected are
+ * recomputed, and only for the piece types present around them; the rest
+ * of the set is kept.
+ */
+void updateMovesBitBoard( const BitBoard *bb, MoveSet *moves, uint64_t changed ) {
+
+    if ( changed == 0 ) {
+        return;
+    }
+
+    uint64_t region = grow( changed );
+    uint64_t right;
+    uint64_t down;
+
+    findMovesInRegion( bb, grow( region ), &right, &down );
+
+    moves->right = ( moves->right & ~region ) | ( right & region );
+    moves->down = ( moves->down & ~region ) | ( down & region );
+
+}
+
+/**
+ * @brief Returns how many swaps the move set holds.
+ */
+int countMovesBitBoard( const MoveSet *moves ) {
+    return __builtin_popcountll( moves->right ) + __builtin_popcountll( moves->down );
+}
+
+/**
+ * @brief Copies up to capacity swaps of the move set to list, in row-major
+ * order of their first cell. Returns how many were copied.
+ */
+int listMovesBitBoard( const MoveSet *moves, Move *list, int capacity ) {
+
+    int count = 0;
+    uint64_t any = moves->right | moves->down;
+
+    while ( any != 0 && count < capacity ) {
+
+        int cell = __builtin_ctzll( any );
+        int row = cell / BITBOARD_SIZE;
+        int col = cell % BITBOARD_SIZE;
+        uint64_t bit = 1ULL << cell;
+
+        if ( ( moves->right & bit ) && count < capacity ) {
+            list[count++] = (Move) { row, col, row, col + 1 };
+        }
+
+        if ( ( moves->down & bit ) && count < capacity ) {
+            list[count++] = (Move) { row, col, row + 1, col };
+        }
+
+        any &= any - 1;
+
+    }
+
+    return count;
+
+}
@@ -0,0 +1,176 @@
+/**
+ * @file Board.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Board implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "Board.h"
+
+// columns per job of applyGravityTiledBoard
+#define GRAVITY_BAND_COLS 64
+
+typedef struct GravityBands {
+    Board *board;
+    Gravity *gravity;
+} GravityBands;
+
+/**
+ * @brief Returns true if a board of width x height cells is supported.
+ */
+bool isValidSizeBoard( int width, int height ) {
+    return width >= 1 && width <= BOARD_MAX_SIZE && height >= 1 && height <= BOARD_MAX_SIZE;
+}
+
+/**
+ * @brief Initializes an empty board (all cells with PIECE_NULL) over
+ * cells, which must hold width * height bytes.
+ */
+void initBoard( Board *board, int width, int height, uint8_t *cells ) {
+    board->width = width;
+    board->height = height;
+    board->cells = cells;
+    memset( cells, PIECE_NULL, (size_t) width * height );
+}
+
+/**
+ * @brief Creates a dinamically allocated empty board, with its cells.
+ * Returns NULL if the size is not supported.
+ */
+Board* createBoard( int width, int height ) {
+
+    if ( !isValidSizeBoard( width, height ) ) {
+        return NULL;
+    }
+
+    // a single allocation: the cells follow the struct
+    Board *board = (Board*) malloc( sizeof( Board ) + (size_t) width * height );
+    initBoard( board, width, height, (uint8_t*) ( board + 1 ) );
+
+    return board;
+
+}
+
+/**
+ * @brief Destroys a board created with createBoard.
+ */
+void destroyBoard( Board *board ) {
+    free( board );
+}
+
+/**
+ * @brief Copies the size and the cells of src to dst, whose cells must
+ * have room for them.
+ */
+void copyBoard( Board *dst, const Board *src ) {
+    dst->width = src->width;
+    dst->height = src->height;
+    memcpy( dst->cells, src->cells, (size_t) src->width * src->height );
+}
+
+/**
+ * @brief Returns true if both boards have the same size and cells.
+ */
+bool equalsBoard( const Board *a, const Board *b ) {
+    return a->width == b->width && a->height == b->height &&
+           memcmp( a->cells, b->cells, (size_t) a->width * a->height ) == 0;
+}
+
+/**
+ * @brief Returns the piece type at ( row, col ).
+ */
+PieceType getPieceBoard( const Board *board, int row, int col ) {
+    return board->cells[row * board->width + col];
+}
+
+/**
+ * @brief Stores a piece type at ( row, col ).
+ */
+void setPieceBoard( Board *board, int row, int col, PieceType type ) {
+    board->cells[row * board->width + col] = type;
+}
+
+/**
+ * @brief Creates a dinamically allocated gravity result with room for a
+ * board of width x height cells.
+ */
+Gravity* createGravity( int width, int height ) {
+    Gravity *gravity = (Gravity*) malloc( sizeof( Gravity ) );
+    gravity->fall = (int*) malloc( (size_t) width * height * sizeof( int ) );
+    gravity->newPieces = (int*) malloc( (size_t) width * sizeof( int ) );
+    return gravity;
+}
+
+/**
+ * @brief Destroys a gravity result created with createGravity.
+ */
+void destroyGravity( Gravity *gravity ) {
+    if ( gravity != NULL ) {
+        free( gravity->fall );
+        free( gravity->newPieces );
+        free( gravity );
+    }
+}
+
+// compacts a band of columns, walking it row by row from the bottom with
+// a write cursor per column, so reads and writes go along the rows
+static void fallBand( void *data, int job, int worker ) {
+
+    GravityBands *bands = (GravityBands*) data;
+    int width = bands->board->width;
+    int height = bands->board->height;
+    uint8_t *cells = bands->board->cells;
+    int *fall = bands->gravity->fall;
+    int first = job * GRAVITY_BAND_COLS;
+    int last = first + GRAVITY_BAND_COLS < width ? first + GRAVITY_BAND_COLS : width;
+    int write[GRAVITY_BAND_COLS];
+
+    for ( int j = first; j < last; j++ ) {
+        write[j - first] = height - 1;
+    }
+
+    for ( int read = height - 1; read >= 0; read-- ) {
+        for ( int j = first; j < last; j++ ) {
+            uint8_t type = cells[read * width + j];
+            if ( type != PIECE_NULL ) {
+                int w = write[j - first]--;
+                cells[w * width + j] = type;
+                fall[w * width + j] = w - read;
+            }
+        }
+    }
+
+    for ( int j = first; j < last; j++ ) {
+        int top = write[j - first];
+        bands->gravity->newPieces[j] = top + 1;
+        for ( int i = top; i >= 0; i-- ) {
+            cells[i * width + j] = PIECE_NULL;
+            fall[i * width + j] = top + 1;
+        }
+    }
+
+}
+
+/**
+ * @brief Lets every piece fall over the empty cells below it, compacting
+ * each column in a single bottom-up pass with a write cursor. The empty
+ * cells end at the top of each column. Fall distances and new piece
+ * counts are stored in gravity.
+ */
+void applyGravityBoard( Board *board, Gravity *gravity ) {
+    applyGravityTiledBoard( NULL, board, gravity );
+}
+
+/**
+ * @brief Same as applyGravityBoard, with the columns split into bands
+ * that fall in parallel on pool (on the calling thread when pool is
+ * NULL). Columns never interact, so the result is the same.
+ */
+void applyGravityTiledBoard( ThreadPool *pool, Board *board, Gravity *gravity ) {
+    GravityBands bands = { board, gravity };
+    runThreadPool( pool, ( board->width + GRAVITY_BAND_COLS - 1 ) / GRAVITY_BAND_COLS, fallBand, &bands );
+}
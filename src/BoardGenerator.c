@@ -0,0 +1,577 @@
+/**
+ * @file BoardGenerator.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Board generation implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "BoardGenerator.h"
+#include "BitBoard.h"
+#include "Cascade.h"
+
+// how many cells (and pieces left) a reshuffle repair looks at, and how
+// many random pieces a cell tries before taking the next one that fits
+#define REPAIR_WINDOW 256
+#define DRAW_TRIES 4
+
+// reshuffles tried (on large boards, each in another region) before the
+// last resort of ensureMovesBoard
+#define RESHUFFLE_ATTEMPTS 4
+
+// type of the cell offset cells away from p when the neighbor exists,
+// PIECE_NULL otherwise
+#define NEIGHBOR( p, offset, exists ) ( ( exists ) ? ( p )[offset] : PIECE_NULL )
+
+// bit of type t set when t, placed at ( row, col ), would make a run with
+// the filled cells around it; at most six types are forbidden, so at least
+// one is always allowed
+static unsigned forbiddenTypes( const Board *board, int row, int col ) {
+
+    int width = board->width;
+    const uint8_t *p = board->cells + row * width + col;
+    int left1 = NEIGHBOR( p, -1, col >= 1 );
+    int left2 = NEIGHBOR( p, -2, col >= 2 );
+    int right1 = NEIGHBOR( p, 1, col + 1 < width );
+    int right2 = NEIGHBOR( p, 2, col + 2 < width );
+    int up1 = NEIGHBOR( p, -width, row >= 1 );
+    int up2 = NEIGHBOR( p, -2 * width, row >= 2 );
+    int down1 = NEIGHBOR( p, width, row + 1 < board->height );
+    int down2 = NEIGHBOR( p, 2 * width, row + 2 < board->height );
+    unsigned forbidden = 0;
+
+    forbidden |= (unsigned) ( left1 == left2 ) << left1;
+    forbidden |= (unsigned) ( right1 == right2 ) << right1;
+    forbidden |= (unsigned) ( left1 == right1 ) << left1;
+    forbidden |= (unsigned) ( up1 == up2 ) << up1;
+    forbidden |= (unsigned) ( down1 == down2 ) << down1;
+    forbidden |= (unsigned) ( up1 == down1 ) << up1;
+
+    // pairs of empty cells forbid nothing
+    return forbidden & ~( 1u << PIECE_NULL );
+
+}
+
+// fills allowed with the types that, placed at ( row, col ), do not make a
+// run with the filled cells around it and returns how many there are
+static int allowedTypes( const Board *board, int row, int col, int *allowed ) {
+
+    unsigned forbidden = forbiddenTypes( board, row, col );
+    int count = 0;
+
+    for ( int type = 1; type < PIECE_TYPE_COUNT; type++ ) {
+        if ( !( forbidden & ( 1u << type ) ) ) {
+            allowed[count++] = type;
+        }
+    }
+
+    return count;
+
+}
+
+// cells of "X X _ / _ _ X" (swapping the last X up completes the row) and
+// its gap, at the given anchor, flip and orientation
+static void movePattern( int row, int col, int variant, int cells[4][2] ) {
+
+    static const int pattern[4][2] = { { 0, 0 }, { 0, 1 }, { 1, 2 }, { 0, 2 } };
+    bool flipRows = variant & 1;
+    bool flipCols = variant & 2;
+    bool transposed = variant & 4;
+
+    for ( int k = 0; k < 4; k++ ) {
+        int r = pattern[k][0];
+        int c = pattern[k][1];
+        if ( flipRows ) {
+            r = 1 - r;
+        }
+        if ( flipCols ) {
+            c = 2 - c;
+        }
+        if ( transposed ) {
+            int t = r;
+            r = c;
+            c = t;
+        }
+        cells[k][0] = row + r;
+        cells[k][1] = col + c;
+    }
+
+}
+
+// plants the three pieces of a legal move with type at a random place where
+// none of its cells (and the gap) is empty in holes, when given, and they
+// make no run with the pieces already there, storing their indexes in
+// planted; returns false if no such place exists
+static bool plantMove( Board *board, const Board *holes, PieceType type, Rng *rng, int *planted ) {
+
+    int width = board->width;
+    int height = board->height;
+    int anchors = width * height;
+    int firstAnchor = boundedRng( rng, anchors );
+    int firstVariant = boundedRng( rng, 8 );
+
+    // random starting point, then every anchor and variant in turn: the
+    // first try always succeeds on boards without holes
+    for ( int a = 0; a < anchors; a++ ) {
+        int anchor = ( firstAnchor + a ) % anchors;
+        for ( int v = 0; v < 8; v++ ) {
+            int variant = ( firstVariant + v ) % 8;
+            int boxHeight = variant & 4 ? 3 : 2;
+            int boxWidth = variant & 4 ? 2 : 3;
+            int row = anchor / width;
+            int col = anchor % width;
+            if ( row + boxHeight > height || col + boxWidth > width ) {
+                continue;
+            }
+            int cells[4][2];
+            bool fits = true;
+            movePattern( row, col, variant, cells );
+            for ( int k = 0; k < 4 && fits; k++ ) {
+                fits = holes == NULL || holes->cells[cells[k][0] * width + cells[k][1]] != PIECE_NULL;
+            }
+            if ( fits ) {
+                for ( int k = 0; k < 3; k++ ) {
+                    setPieceBoard( board, cells[k][0], cells[k][1], type );
+                    planted[k] = cells[k][0] * width + cells[k][1];
+                }
+                // pieces already on the board (around a reshuffled region)
+                // must not make a run with them
+                for ( int k = 0; k < 3 && fits; k++ ) {
+                    fits = !( forbiddenTypes( board, cells[k][0], cells[k][1] ) & ( 1u << type ) );
+                }
+                if ( fits ) {
+                    return true;
+                }
+                for ( int k = 0; k < 3; k++ ) {
+                    setPieceBoard( board, cells[k][0], cells[k][1], PIECE_NULL );
+                }
+            }
+        }
+    }
+
+    return false;
+
+}
+
+// moves the piece at pool[j] to pool[next], the next one to be placed
+static int takePiece( uint8_t *pool, int next, int j ) {
+    uint8_t type = pool[j];
+    pool[j] = pool[next];
+    pool[next] = type;
+    return type;
+}
+
+// draws a piece not in forbidden from the pieces left, pool[next..count),
+// and moves it to pool[next]. Random pieces are tried first, as in a
+// Fisher-Yates shuffle that skips the ones that would make a run, so each
+// type comes with a chance proportional to how many of it are left; after
+// a few misses the pieces after next are tried in order. Returns
+// PIECE_NULL when none of the REPAIR_WINDOW pieces tried fits
+static int drawPiece( unsigned forbidden, uint8_t *pool, int next, int count, Rng *rng ) {
+
+    for ( int t = 0; t < DRAW_TRIES; t++ ) {
+        int j = next + boundedRng( rng, count - next );
+        if ( !( forbidden & ( 1u << pool[j] ) ) ) {
+            return takePiece( pool, next, j );
+        }
+    }
+
+    for ( int j = next; j < count && j < next + REPAIR_WINDOW; j++ ) {
+        if ( !( forbidden & ( 1u << pool[j] ) ) ) {
+            return takePiece( pool, next, j );
+        }
+    }
+
+    return PIECE_NULL;
+
+}
+
+// no piece left fits the cell at index: looks for a free earlier cell
+// whose piece fits here while one of the next REPAIR_WINDOW pieces left
+// fits there, and exchanges them. The REPAIR_WINDOW cells right before
+// index are tried first and then as many random earlier cells, since with
+// a dominant color the room for it can be anywhere on the board; either
+// way a repair is O(1). The piece used is moved to pool[next]. Returns
+// false when no exchange was found
+static bool repairCell( Board *board, const Board *holes, const int *planted, int index, uint8_t *pool, int next, int count, Rng *rng ) {
+
+    int width = board->width;
+    int row = index / width;
+    int col = index % width;
+    int nearby = index < REPAIR_WINDOW ? index : REPAIR_WINDOW;
+
+    for ( int t = 0; t < nearby + REPAIR_WINDOW && index > 0; t++ ) {
+
+        int k = t < nearby ? index - 1 - t : boundedRng( rng, index );
+
+        if ( holes->cells[k] == PIECE_NULL || k == planted[0] || k == planted[1] || k == planted[2] ) {
+            continue;
+        }
+
+        int type = board->cells[k];
+        board->cells[k] = PIECE_NULL;
+
+        if ( !( forbiddenTypes( board, row, col ) & ( 1u << type ) ) ) {
+            board->cells[index] = type;
+            unsigned forbidden = forbiddenTypes( board, k / width, k % width );
+            for ( int j = next; j < count && j < next + REPAIR_WINDOW; j++ ) {
+                if ( !( forbidden & ( 1u << pool[j] ) ) ) {
+                    board->cells[k] = takePiece( pool, next, j );
+                    return true;
+                }
+            }
+            board->cells[index] = PIECE_NULL;
+        }
+
+        board->cells[k] = type;
+
+    }
+
+    return false;
+
+}
+
+/**
+ * @brief Fills the board (with its width and height already set) with
+ * random pieces. A random legal move is planted first and then each cell
+ * takes a random type among the ones that do not complete a run with the
+ * cells already filled, so no rejection loop is needed. Boards smaller
+ * than 3 x 2 cells cannot hold a move and only get the no-match guarantee.
+ */
+void generateBoard( Board *board, Rng *rng ) {
+
+    int allowed[PIECE_TYPE_COUNT];
+    int planted[3];
+
+    initBoard( board, board->width, board->height, board->cells );
+    plantMove( board, NULL, nextPieceRng( rng ), rng, planted );
+
+    for ( int i = 0; i < board->height; i++ ) {
+        for ( int j = 0; j < board->width; j++ ) {
+            if ( getPieceBoard( board, i, j ) == PIECE_NULL ) {
+                int count = allowedTypes( board, i, j, allowed );
+                setPieceBoard( board, i, j, allowed[boundedRng( rng, count )] );
+            }
+        }
+    }
+
+}
+
+// builds the rearrangement of reshuffleBoard in result: the pieces of board
+// go to its cells, the empty cells of board are left as they are in result
+// (holes, or pieces around the region that must not make runs with it);
+// pool is scratch space with one entry per cell
+static bool rearrange( const Board *board, Rng *rng, uint8_t *pool, Board *result ) {
+
+    int cellCount = board->width * board->height;
+    int counts[PIECE_TYPE_COUNT] = { 0 };
+    int candidates[PIECE_TYPE_COUNT];
+    int candidateCount = 0;
+    int count = 0;
+
+    // every piece of the board, in order
+    for ( int i = 0; i < cellCount; i++ ) {
+        int type = board->cells[i];
+        counts[type]++;
+        pool[count] = type;
+        count += type != PIECE_NULL;
+    }
+
+    for ( int type = 1; type < PIECE_TYPE_COUNT; type++ ) {
+        if ( counts[type] >= 3 ) {
+            candidates[candidateCount++] = type;
+        }
+    }
+
+    if ( candidateCount == 0 ) {
+        return false;
+    }
+
+    PieceType moveType = candidates[boundedRng( rng, candidateCount )];
+    int planted[3];
+
+    if ( !plantMove( result, board, moveType, rng, planted ) ) {
+        return false;
+    }
+
+    // the three planted pieces leave the pool
+    for ( int j = 0, removed = 0; removed < 3; j++ ) {
+        if ( pool[j] == moveType ) {
+            pool[j--] = pool[--count];
+            removed++;
+        }
+    }
+
+    // cells are filled in row-major order, so the cells ahead of one are
+    // empty unless planted or around the region: outside the box of cells
+    // with a planted cell up to two to the right or below, and away from
+    // the last three rows and columns, only the two cells to the left and
+    // the two above can make a run with it
+    int width = board->width;
+    int top = planted[0] / width;
+    int bottom = top;
+    int left = planted[0] % width;
+    int right = left;
+
+    for ( int k = 1; k < 3; k++ ) {
+        top = planted[k] / width < top ? planted[k] / width : top;
+        bottom = planted[k] / width > bottom ? planted[k] / width : bottom;
+        left = planted[k] % width < left ? planted[k] % width : left;
+        right = planted[k] % width > right ? planted[k] % width : right;
+    }
+
+    int next = 0;
+
+    for ( int row = 0; row < board->height; row++ ) {
+        for ( int col = 0; col < width; col++ ) {
+
+            int i = row * width + col;
+            const uint8_t *p = result->cells + i;
+            unsigned forbidden;
+
+            // holes and planted cells stay as they are
+            if ( board->cells[i] == PIECE_NULL || *p != PIECE_NULL ) {
+                continue;
+            }
+
+            if ( row >= 2 && col >= 2 && row < board->height - 3 && col < width - 3 &&
+                 ( row < top - 2 || row > bottom || col < left - 2 || col > right ) ) {
+                forbidden = ( (unsigned) ( p[-1] == p[-2] ) << p[-1] | (unsigned) ( p[-width] == p[-2 * width] ) << p[-width] ) &
+                            ~( 1u << PIECE_NULL );
+            } else {
+                forbidden = forbiddenTypes( result, row, col );
+            }
+
+            int type = drawPiece( forbidden, pool, next, count, rng );
+
+            if ( type != PIECE_NULL ) {
+                result->cells[i] = type;
+            } else if ( !repairCell( result, board, planted, i, pool, next, count, rng ) ) {
+                return false;
+            }
+
+            next++;
+
+        }
+    }
+
+    return true;
+
+}
+
+// last resort of ensureMovesBoard: exchanges three pieces of one type with
+// the cells of a move pattern, at a random place where no piece involved
+// makes a run, so the counts are kept. Returns false if there is no such
+// place (e.g. no type has three pieces)
+static bool exchangeMove( Board *board, Rng *rng ) {
+
+    int width = board->width;
+    int cellCount = width * board->height;
+    int firstType = 1 + boundedRng( rng, PIECE_TYPE_COUNT - 1 );
+    int firstAnchor = boundedRng( rng, cellCount );
+
+    for ( int t = 0; t < PIECE_TYPE_COUNT - 1; t++ ) {
+
+        int type = 1 + ( firstType - 1 + t ) % ( PIECE_TYPE_COUNT - 1 );
+        int sources[6];
+        int sourceCount = 0;
+
+        // six pieces of the type are enough: a pattern covers at most three
+        for ( int i = 0; i < cellCount && sourceCount < 6; i++ ) {
+            if ( board->cells[( firstAnchor + i ) % cellCount] == type ) {
+                sources[sourceCount++] = ( firstAnchor + i ) % cellCount;
+            }
+        }
+
+        if ( sourceCount < 3 ) {
+            continue;
+        }
+
+        for ( int a = 0; a < cellCount; a++ ) {
+
+            int anchor = ( firstAnchor + a ) % cellCount;
+
+            for ( int variant = 0; variant < 8; variant++ ) {
+
+                int cells[4][2];
+                int changed[6];
+                int changedCount = 0;
+                int next = 0;
+                bool fits = true;
+
+                if ( anchor / width + ( variant & 4 ? 3 : 2 ) > board->height ||
+                     anchor % width + ( variant & 4 ? 2 : 3 ) > width ) {
+                    continue;
+                }
+
+                movePattern( anchor / width, anchor % width, variant, cells );
+
+                for ( int k = 0; k < 4 && fits; k++ ) {
+                    fits = getPieceBoard( board, cells[k][0], cells[k][1] ) != PIECE_NULL;
+                }
+
+                // each pattern cell without the type takes a piece of it
+                // from a source outside the pattern
+                for ( int k = 0; k < 3 && fits; k++ ) {
+                    int cell = cells[k][0] * width + cells[k][1];
+                    if ( board->cells[cell] == type ) {
+                        continue;
+                    }
+                    while ( next < sourceCount ) {
+                        int source = sources[next++];
+                        bool inPattern = false;
+                        for ( int m = 0; m < 4; m++ ) {
+                            inPattern = inPattern || source == cells[m][0] * width + cells[m][1];
+                        }
+                        if ( !inPattern ) {
+                            board->cells[source] = board->cells[cell];
+                            board->cells[cell] = type;
+                            changed[changedCount++] = cell;
+                            changed[changedCount++] = source;
+                            break;
+                        }
+                    }
+                    fits = board->cells[cell] == type;
+                }
+
+                for ( int k = 0; k < changedCount && fits; k++ ) {
+                    fits = !( forbiddenTypes( board, changed[k] / width, changed[k] % width ) &
+                              ( 1u << board->cells[changed[k]] ) );
+                }
+
+                if ( fits ) {
+                    return true;
+                }
+
+                // undone in reverse order
+                for ( int k = changedCount - 2; k >= 0; k -= 2 ) {
+                    board->cells[changed[k]] = board->cells[changed[k + 1]];
+                    board->cells[changed[k + 1]] = type;
+                }
+
+            }
+
+        }
+
+    }
+
+    return false;
+
+}
+
+/**
+ * @brief Rearranges the pieces of the board keeping how many pieces of
+ * each type there are (empty cells stay where they are). The result has
+ * no matches and at least one legal move. Like generateBoard it plants a
+ * move and fills the other cells in one pass, each drawing a random piece
+ * among the ones left that do not make a run there; when none fits, an
+ * earlier cell, near or random, is exchanged with it. Boards larger than
+ * RESHUFFLE_REGION_SIZE on a side only have a random region of that size
+ * rearranged, without runs with the pieces around it, so a reshuffle
+ * takes the same time on any board, well within a frame (tools/tiles.c
+ * times it on large boards). Returns false, leaving the board unchanged,
+ * when no arrangement could be built (e.g. no type has three pieces).
+ */
+bool reshuffleBoard( Board *board, Rng *rng ) {
+
+    int width = board->width;
+    int height = board->height;
+    int regionWidth = width < RESHUFFLE_REGION_SIZE ? width : RESHUFFLE_REGION_SIZE;
+    int regionHeight = height < RESHUFFLE_REGION_SIZE ? height : RESHUFFLE_REGION_SIZE;
+    int regionLeft = regionWidth < width ? boundedRng( rng, width - regionWidth + 1 ) : 0;
+    int regionTop = regionHeight < height ? boundedRng( rng, height - regionHeight + 1 ) : 0;
+
+    // the region and up to two cells around it, which can make runs with
+    // its pieces
+    int left = regionLeft >= 2 ? regionLeft - 2 : 0;
+    int top = regionTop >= 2 ? regionTop - 2 : 0;
+    int right = regionLeft + regionWidth + 2 < width ? regionLeft + regionWidth + 2 : width;
+    int bottom = regionTop + regionHeight + 2 < height ? regionTop + regionHeight + 2 : height;
+    int cellCount = ( right - left ) * ( bottom - top );
+
+    uint8_t poolStack[BITBOARD_CELLS];
+    uint8_t piecesStack[BITBOARD_CELLS];
+    uint8_t cellsStack[BITBOARD_CELLS];
+    uint8_t *pool = poolStack;
+    uint8_t *pieces = piecesStack;
+    uint8_t *cells = cellsStack;
+    Board region;
+    Board result;
+
+    if ( cellCount > BITBOARD_CELLS ) {
+        pool = (uint8_t*) malloc( cellCount );
+        pieces = (uint8_t*) malloc( cellCount );
+        cells = (uint8_t*) malloc( cellCount );
+    }
+
+    // region holds the pieces to rearrange, result the pieces around them
+    initBoard( &region, right - left, bottom - top, pieces );
+    initBoard( &result, right - left, bottom - top, cells );
+
+    for ( int row = top; row < bottom; row++ ) {
+        for ( int col = left; col < right; col++ ) {
+            bool inside = row >= regionTop && row < regionTop + regionHeight &&
+                          col >= regionLeft && col < regionLeft + regionWidth;
+            uint8_t type = board->cells[row * width + col];
+            setPieceBoard( inside ? &region : &result, row - top, col - left, type );
+        }
+    }
+
+    bool rearranged = rearrange( &region, rng, pool, &result );
+
+    if ( rearranged ) {
+        for ( int row = regionTop; row < regionTop + regionHeight; row++ ) {
+            for ( int col = regionLeft; col < regionLeft + regionWidth; col++ ) {
+                board->cells[row * width + col] = getPieceBoard( &result, row - top, col - left );
+            }
+        }
+    }
+
+    if ( cells != cellsStack ) {
+        free( pool );
+        free( pieces );
+        free( cells );
+    }
+
+    return rearranged;
+
+}
+
+/**
+ * @brief Makes sure a board has at least one legal move: when it has none
+ * the board is reshuffled (a few times if needed, on large boards each
+ * time in another region) or, as a last resort, three pieces of a type
+ * are exchanged into a move where they make no run. The counts of each
+ * type are always kept. Returns true if the board was changed; false
+ * when it already has a move or no move could be made with its pieces.
+ */
+bool ensureMovesBoard( Board *board, Rng *rng ) {
+
+    // large boards stop scanning at the first move found
+    if ( board->width <= BITBOARD_SIZE && board->height <= BITBOARD_SIZE ) {
+        BitBoard bb;
+        MoveSet moves;
+        loadBitBoard( &bb, board );
+        findMovesBitBoard( &bb, &moves );
+        if ( countMovesBitBoard( &moves ) > 0 ) {
+            return false;
+        }
+    } else {
+        Move move;
+        if ( findMovesBoard( board, &move, 1 ) > 0 ) {
+            return false;
+        }
+    }
+
+    for ( int i = 0; i < RESHUFFLE_ATTEMPTS; i++ ) {
+        if ( reshuffleBoard( board, rng ) ) {
+            return true;
+        }
+    }
+
+    return exchangeMove( board, rng );
+
+}
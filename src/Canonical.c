@@ -0,0 +1,176 @@
+/**
+ * @file Canonical.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Canonical implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Canonical.h"
+#include "Zobrist.h"
+
+// boards up to this many cells keep their candidates on the stack
+#define CANONICAL_STACK_CELLS 64
+
+// relabels the board read in row-major order of its mirror into out,
+// comparing it with best on the way. Returns false as soon as the result
+// is larger than best and true if it is smaller (always when best is NULL)
+static bool relabelMirror( const Board *board, int mirror, const uint8_t *best, uint8_t *out, uint8_t *labels ) {
+
+    int width = board->width;
+    int height = board->height;
+    int rowStep = ( mirror & MIRROR_ROWS ) ? -width : width;
+    int colStep = ( mirror & MIRROR_COLUMNS ) ? -1 : 1;
+    const uint8_t *rowStart = &board->cells[( ( mirror & MIRROR_ROWS ) ? ( height - 1 ) * width : 0 ) +
+                                            ( ( mirror & MIRROR_COLUMNS ) ? width - 1 : 0 )];
+    uint8_t nextLabel = 1;
+    bool smaller = best == NULL;
+    int k = 0;
+
+    memset( labels, 0, PIECE_TYPE_COUNT );
+
+    for ( int i = 0; i < height; i++, rowStart += rowStep ) {
+
+        const uint8_t *src = rowStart;
+
+        // once every color has a label and the order is decided, the rest
+        // is a plain table lookup
+        if ( smaller && nextLabel == PIECE_TYPE_COUNT ) {
+            for ( int j = 0; j < width; j++, src += colStep ) {
+                out[k++] = labels[*src];
+            }
+            continue;
+        }
+
+        for ( int j = 0; j < width; j++, src += colStep, k++ ) {
+
+            uint8_t type = *src;
+            if ( type != PIECE_NULL && labels[type] == 0 ) {
+                labels[type] = nextLabel++;
+            }
+
+            uint8_t label = labels[type];
+            if ( !smaller ) {
+                if ( label > best[k] ) {
+                    return false;
+                }
+                smaller = label < best[k];
+            }
+            out[k] = label;
+
+        }
+
+    }
+
+    return smaller;
+
+}
+
+/**
+ * @brief Stores in canonical the canonical form of board: for each valid
+ * mirror the cells are read in row-major order of the mirrored board and
+ * the colors are relabelled 1, 2, ... in order of first appearance (empty
+ * cells stay empty); the lexicographically smallest result is kept. With
+ * keepGravity only the column mirror is valid, otherwise the row mirror
+ * and both are too. Returns the mirror of the result (0 for none); when
+ * colors is not NULL, colors[label] receives the original type of each
+ * label. Candidates are compared while they are built and dropped at the
+ * first larger cell, so most mirrors cost only a few cells. The cells of
+ * canonical must have room for the cells of board.
+ */
+int canonicalizeBoard( const Board *board, bool keepGravity, Board *canonical, uint8_t *colors ) {
+
+    int mirrorCount = keepGravity ? 2 : 4;
+    int bestMirror = 0;
+    uint8_t bestLabels[PIECE_TYPE_COUNT];
+    uint8_t labels[PIECE_TYPE_COUNT];
+    int cellCount = board->width * board->height;
+    uint8_t candidateStack[CANONICAL_STACK_CELLS];
+    uint8_t *candidate = candidateStack;
+
+    if ( cellCount > CANONICAL_STACK_CELLS ) {
+        candidate = (uint8_t*) malloc( cellCount );
+    }
+
+    canonical->width = board->width;
+    canonical->height = board->height;
+    relabelMirror( board, 0, NULL, canonical->cells, bestLabels );
+
+    for ( int m = 1; m < mirrorCount; m++ ) {
+        if ( relabelMirror( board, m, canonical->cells, candidate, labels ) ) {
+            memcpy( canonical->cells, candidate, cellCount );
+            memcpy( bestLabels, labels, PIECE_TYPE_COUNT );
+            bestMirror = m;
+        }
+    }
+
+    if ( candidate != candidateStack ) {
+        free( candidate );
+    }
+
+    if ( colors != NULL ) {
+        memset( colors, PIECE_NULL, PIECE_TYPE_COUNT );
+        for ( int t = 1; t < PIECE_TYPE_COUNT; t++ ) {
+            if ( bestLabels[t] != 0 ) {
+                colors[bestLabels[t]] = t;
+            }
+        }
+    }
+
+    return bestMirror;
+
+}
+
+/**
+ * @brief Returns the Zobrist hash of the canonical form of board, equal
+ * for every equivalent board.
+ */
+uint64_t hashCanonical( const Board *board, bool keepGravity ) {
+
+    int cellCount = board->width * board->height;
+    uint8_t cells[CANONICAL_STACK_CELLS];
+    Board canonical = { .cells = cells };
+
+    if ( cellCount > CANONICAL_STACK_CELLS ) {
+        canonical.cells = (uint8_t*) malloc( cellCount );
+    }
+
+    canonicalizeBoard( board, keepGravity, &canonical, NULL );
+    uint64_t hash = hashBoardZobrist( &canonical );
+
+    if ( canonical.cells != cells ) {
+        free( canonical.cells );
+    }
+
+    return hash;
+
+}
+
+/**
+ * @brief Maps a move between a board and its mirror (mirrors are their
+ * own inverse, so the same call maps both ways). The result keeps the
+ * convention of the first cell being the left or upper one.
+ */
+Move mirrorMoveCanonical( Move move, int mirror, int width, int height ) {
+
+    if ( mirror & MIRROR_COLUMNS ) {
+        move.c1 = width - 1 - move.c1;
+        move.c2 = width - 1 - move.c2;
+    }
+
+    if ( mirror & MIRROR_ROWS ) {
+        move.r1 = height - 1 - move.r1;
+        move.r2 = height - 1 - move.r2;
+    }
+
+    if ( move.r2 < move.r1 || move.c2 < move.c1 ) {
+        return (Move) { move.r2, move.c2, move.r1, move.c1 };
+    }
+
+    return move;
+
+}
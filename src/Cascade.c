@@ -0,0 +1,425 @@
+/**
+ * @file Cascade.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Cascade implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Cascade.h"
+#include "BitBoard.h"
+#include "Zobrist.h"
+
+// new pieces are drawn for a column this many at a time
+#define CASCADE_COLUMN_CHUNK 64
+
+// columns per job when hashing the pieces that fell
+#define CASCADE_BAND_COLS 64
+
+// the cells of the first column of a bitboard
+#define CASCADE_FIRST_COLUMN 0x0101010101010101ULL
+
+typedef struct FallHash {
+    const Board *board;
+    const Gravity *gravity;
+    uint64_t *hashes;
+} FallHash;
+
+static void clearCascade( Cascade *cascade ) {
+    cascade->depth = 0;
+    cascade->hashDelta = 0;
+    cascade->clearedCells = 0;
+    for ( int i = 0; i <= MATCH_SHAPE_CROSS; i++ ) {
+        cascade->shapes[i] = 0;
+    }
+    cascade->stepCount = 0;
+    cascade->groupCount = 0;
+    cascade->cellCount = 0;
+}
+
+// the hash delta of the pieces of a band of columns that fell: each one
+// moved from cell - fall rows (pieces below the new ones only)
+static void hashFallBand( void *data, int job, int worker ) {
+
+    FallHash *fallHash = (FallHash*) data;
+    const Board *board = fallHash->board;
+    const Gravity *gravity = fallHash->gravity;
+    int first = job * CASCADE_BAND_COLS;
+    int last = first + CASCADE_BAND_COLS < board->width ? first + CASCADE_BAND_COLS : board->width;
+    uint64_t hash = 0;
+
+    for ( int i = 0; i < board->height; i++ ) {
+        for ( int j = first; j < last; j++ ) {
+            int cell = i * board->width + j;
+            if ( i >= gravity->newPieces[j] && gravity->fall[cell] > 0 ) {
+                hash ^= moveZobrist( cell - gravity->fall[cell] * board->width, cell, board->cells[cell] );
+            }
+        }
+    }
+
+    fallHash->hashes[job] = hash;
+
+}
+
+static void recordStep( Cascade *cascade, const MatchList *matches ) {
+
+    cascade->depth++;
+    cascade->clearedCells += matches->cellCount;
+
+    for ( int g = 0; g < matches->groupCount; g++ ) {
+        cascade->shapes[matches->groups[g].shape]++;
+    }
+
+    if ( cascade->stepCount == CASCADE_STEP_CAPACITY ) {
+        return;
+    }
+
+    CascadeStep *step = &cascade->steps[cascade->stepCount++];
+    step->firstGroup = cascade->groupCount;
+    step->groupCount = 0;
+    step->clearedCells = matches->cellCount;
+
+    for ( int g = 0; g < matches->groupCount; g++ ) {
+        const MatchGroup *src = &matches->groups[g];
+        if ( cascade->groupCount == CASCADE_GROUP_CAPACITY ||
+             cascade->cellCount + src->cellCount > CASCADE_CELL_CAPACITY ) {
+            break;
+        }
+        MatchGroup *dst = &cascade->groups[cascade->groupCount++];
+        *dst = *src;
+        dst->firstCell = cascade->cellCount;
+        for ( int k = 0; k < src->cellCount; k++ ) {
+            cascade->cells[cascade->cellCount++] = matches->cells[src->firstCell + k];
+        }
+        step->groupCount++;
+    }
+
+}
+
+// the cascade of a board that fits a bitboard, counting its depth and
+// cleared cells only: the matches come straight from bb, which is reloaded
+// after every step, and only the columns with empty cells fall and refill
+// (in column order, so rng gives the same pieces as in resolveBoard)
+static void resolveTotalsBitBoard( Board *board, BitBoard *bb, Rng *rng, Cascade *cascade ) {
+
+    int width = board->width;
+    int height = board->height;
+    uint8_t *cells = board->cells;
+    uint8_t column[BITBOARD_SIZE];
+    uint64_t matches;
+
+    while ( ( matches = findAllMatchesBitBoard( bb ) ) != 0 ) {
+
+        uint64_t empty = bb->pieces[PIECE_NULL] | matches;
+
+        cascade->depth++;
+        cascade->clearedCells += __builtin_popcountll( matches );
+
+        for ( int j = 0; j < width; j++ ) {
+
+            if ( ( empty >> j & CASCADE_FIRST_COLUMN ) == 0 ) {
+                continue;
+            }
+
+            int write = height - 1;
+            for ( int read = height - 1; read >= 0; read-- ) {
+                uint8_t type = cells[read * width + j];
+                if ( type != PIECE_NULL && ( matches >> ( read * BITBOARD_SIZE + j ) & 1 ) == 0 ) {
+                    cells[write-- * width + j] = type;
+                }
+            }
+
+            int count = write + 1;
+            if ( rng != NULL ) {
+                fillPiecesRng( rng, column, count );
+            }
+            for ( int i = 0; i < count; i++ ) {
+                cells[i * width + j] = rng != NULL ? column[i] : PIECE_NULL;
+            }
+
+        }
+
+        loadBitBoard( bb, board );
+
+    }
+
+}
+
+/**
+ * @brief Returns true if the two cells of the move are inside the board,
+ * are neighbors and hold different pieces.
+ */
+bool isSwapAllowed( const Board *board, Move move ) {
+
+    if ( move.r1 < 0 || move.r1 >= board->height || move.c1 < 0 || move.c1 >= board->width ||
+         move.r2 < 0 || move.r2 >= board->height || move.c2 < 0 || move.c2 >= board->width ) {
+        return false;
+    }
+
+    if ( abs( move.r1 - move.r2 ) + abs( move.c1 - move.c2 ) != 1 ) {
+        return false;
+    }
+
+    PieceType p1 = getPieceBoard( board, move.r1, move.c1 );
+    PieceType p2 = getPieceBoard( board, move.r2, move.c2 );
+
+    return p1 != p2 && p1 != PIECE_NULL && p2 != PIECE_NULL;
+
+}
+
+// how many cells after ( row, col ), walking by ( dRow, dCol ), hold type,
+// stopping at the cell ( skipRow, skipCol ) the piece was swapped from
+static int lineLength( const Board *board, int row, int col, int dRow, int dCol, PieceType type, int skipRow, int skipCol ) {
+
+    int length = 0;
+
+    for ( ;; ) {
+        row += dRow;
+        col += dCol;
+        if ( row < 0 || row >= board->height || col < 0 || col >= board->width ||
+             ( row == skipRow && col == skipCol ) || getPieceBoard( board, row, col ) != type ) {
+            return length;
+        }
+        length++;
+    }
+
+}
+
+// true if a piece of type arriving at ( row, col ) from ( fromRow, fromCol )
+// completes a run
+static bool makesRun( const Board *board, int row, int col, PieceType type, int fromRow, int fromCol ) {
+    int h = lineLength( board, row, col, 0, -1, type, fromRow, fromCol ) +
+            lineLength( board, row, col, 0, 1, type, fromRow, fromCol );
+    int v = lineLength( board, row, col, -1, 0, type, fromRow, fromCol ) +
+            lineLength( board, row, col, 1, 0, type, fromRow, fromCol );
+    return h >= 2 || v >= 2;
+}
+
+/**
+ * @brief Returns true if the swap is allowed and makes a match. Only the
+ * lines through the two cells are looked at, so it works on boards of any
+ * size (small boards can use a bitboard move set instead).
+ */
+bool isMatchingSwapBoard( const Board *board, Move move ) {
+
+    if ( !isSwapAllowed( board, move ) ) {
+        return false;
+    }
+
+    PieceType p1 = getPieceBoard( board, move.r1, move.c1 );
+    PieceType p2 = getPieceBoard( board, move.r2, move.c2 );
+
+    return makesRun( board, move.r1, move.c1, p2, move.r2, move.c2 ) ||
+           makesRun( board, move.r2, move.c2, p1, move.r1, move.c1 );
+
+}
+
+/**
+ * @brief Lists the swaps of the board that make a match, in row-major
+ * order of their first cell (the right swap before the down one), in
+ * moves. The scan stops once capacity swaps were found, so asking for a
+ * single one is enough to know if a large board has any. Returns how many
+ * were stored.
+ */
+int findMovesBoard( const Board *board, Move *moves, int capacity ) {
+
+    int count = 0;
+
+    for ( int i = 0; i < board->height; i++ ) {
+        for ( int j = 0; j < board->width; j++ ) {
+            Move candidates[2] = { { i, j, i, j + 1 }, { i, j, i + 1, j } };
+            for ( int k = 0; k < 2; k++ ) {
+                if ( count == capacity ) {
+                    return count;
+                }
+                if ( isMatchingSwapBoard( board, candidates[k] ) ) {
+                    moves[count++] = candidates[k];
+                }
+            }
+        }
+    }
+
+    return count;
+
+}
+
+/**
+ * @brief Removes every match of the board, lets the pieces fall and
+ * refills the empty cells, repeating until no match remains. New pieces
+ * are drawn from rng column by column, from top to bottom; when rng is
+ * NULL the empty cells are kept empty. Returns the cascade depth.
+ */
+int resolveBoard( Board *board, Rng *rng, Cascade *cascade ) {
+    return resolveTiledBoard( NULL, NULL, board, rng, cascade );
+}
+
+/**
+ * @brief Same as resolveBoard, with the match scan, the fall of the
+ * pieces and its hashing split into bands of rows and columns that run in
+ * parallel on pool (on the calling thread when pool is NULL). The result,
+ * including the refills drawn from rng, is the same. Boards larger than a
+ * bitboard take their scratch arrays from scratch, given back before
+ * returning, or allocate them when it is NULL.
+ */
+int resolveTiledBoard( ThreadPool *pool, Arena *scratch, Board *board, Rng *rng, Cascade *cascade ) {
+
+    int cellCount = board->width * board->height;
+    MatchGroup groups[MATCH_GROUP_CAPACITY( BITBOARD_CELLS )];
+    Position cells[BITBOARD_CELLS];
+    int fall[BITBOARD_CELLS];
+    int newPieces[BITBOARD_SIZE];
+    uint8_t column[CASCADE_COLUMN_CHUNK];
+    MatchList matches;
+    Gravity gravity = { fall, newPieces };
+    int bandCount = ( board->width + CASCADE_BAND_COLS - 1 ) / CASCADE_BAND_COLS;
+    uint64_t hashesStack[( BITBOARD_SIZE + CASCADE_BAND_COLS - 1 ) / CASCADE_BAND_COLS];
+    FallHash fallHash = { board, &gravity, hashesStack };
+    ArenaMark mark = { 0 };
+
+    // the small boards the engines resolve many times live on the stack
+    if ( board->width <= BITBOARD_SIZE && board->height <= BITBOARD_SIZE ) {
+        initMatchList( &matches, BITBOARD_CELLS, groups, cells );
+    } else if ( scratch != NULL ) {
+        mark = markArena( scratch );
+        initMatchList( &matches, cellCount,
+                       (MatchGroup*) allocArena( scratch, MATCH_GROUP_CAPACITY( cellCount ) * sizeof( MatchGroup ) ),
+                       (Position*) allocArena( scratch, cellCount * sizeof( Position ) ) );
+        matches.scratch = scratch;
+        gravity.fall = (int*) allocArena( scratch, cellCount * sizeof( int ) );
+        gravity.newPieces = (int*) allocArena( scratch, board->width * sizeof( int ) );
+        fallHash.hashes = (uint64_t*) allocArena( scratch, bandCount * sizeof( uint64_t ) );
+    } else {
+        initMatchList( &matches, cellCount,
+                       (MatchGroup*) malloc( MATCH_GROUP_CAPACITY( cellCount ) * sizeof( MatchGroup ) ),
+                       (Position*) malloc( cellCount * sizeof( Position ) ) );
+        gravity.fall = (int*) malloc( cellCount * sizeof( int ) );
+        gravity.newPieces = (int*) malloc( board->width * sizeof( int ) );
+        fallHash.hashes = (uint64_t*) malloc( bandCount * sizeof( uint64_t ) );
+    }
+
+    clearCascade( cascade );
+
+    // the scan starts from the run mask of the board (its bitboard on small
+    // boards) and returns at once when nothing matched
+    while ( findMatchGroupsTiled( pool, board, &matches ) > 0 ) {
+
+        recordStep( cascade, &matches );
+
+        for ( int k = 0; k < matches.cellCount; k++ ) {
+            int cell = matches.cells[k].row * board->width + matches.cells[k].col;
+            cascade->hashDelta ^= keyZobrist( cell, board->cells[cell] );
+            board->cells[cell] = PIECE_NULL;
+        }
+
+        applyGravityTiledBoard( pool, board, &gravity );
+
+        runThreadPool( pool, bandCount, hashFallBand, &fallHash );
+        for ( int b = 0; b < bandCount; b++ ) {
+            cascade->hashDelta ^= fallHash.hashes[b];
+        }
+
+        if ( rng != NULL ) {
+            // drawing a column in chunks takes the same pieces from rng
+            for ( int j = 0; j < board->width; j++ ) {
+                for ( int first = 0; first < gravity.newPieces[j]; first += CASCADE_COLUMN_CHUNK ) {
+                    int count = gravity.newPieces[j] - first;
+                    if ( count > CASCADE_COLUMN_CHUNK ) {
+                        count = CASCADE_COLUMN_CHUNK;
+                    }
+                    fillPiecesRng( rng, column, count );
+                    for ( int k = 0; k < count; k++ ) {
+                        setPieceBoard( board, first + k, j, column[k] );
+                        cascade->hashDelta ^= keyZobrist( ( first + k ) * board->width + j, column[k] );
+                    }
+                }
+            }
+        }
+
+    }
+
+    if ( matches.scratch != NULL ) {
+        rewindArena( scratch, mark );
+    } else if ( matches.groups != groups ) {
+        free( matches.groups );
+        free( matches.cells );
+        free( gravity.fall );
+        free( gravity.newPieces );
+        free( fallHash.hashes );
+    }
+
+    return cascade->depth;
+
+}
+
+/**
+ * @brief Swaps the two pieces of the move and resolves the board until it
+ * is stable. If the swap is not allowed or does not make a match, the
+ * board is left unchanged and false is returned.
+ */
+bool resolveSwapBoard( Board *board, Move move, Rng *rng, Cascade *cascade ) {
+
+    clearCascade( cascade );
+
+    if ( !isSwapAllowed( board, move ) ) {
+        return false;
+    }
+
+    PieceType p1 = getPieceBoard( board, move.r1, move.c1 );
+    PieceType p2 = getPieceBoard( board, move.r2, move.c2 );
+    setPieceBoard( board, move.r1, move.c1, p2 );
+    setPieceBoard( board, move.r2, move.c2, p1 );
+
+    if ( resolveBoard( board, rng, cascade ) == 0 ) {
+        setPieceBoard( board, move.r1, move.c1, p1 );
+        setPieceBoard( board, move.r2, move.c2, p2 );
+        return false;
+    }
+
+    int a = move.r1 * board->width + move.c1;
+    int b = move.r2 * board->width + move.c2;
+    cascade->hashDelta ^= keyZobrist( a, p1 ) ^ keyZobrist( b, p1 ) ^ keyZobrist( a, p2 ) ^ keyZobrist( b, p2 );
+
+    return true;
+
+}
+
+/**
+ * @brief Same as resolveSwapBoard, for callers that only need the totals
+ * of the cascade: on boards that fit a bitboard only its depth and cleared
+ * cells are stored (no steps, shapes or hash delta), skipping the match
+ * groups and the hashing of resolveBoard. The board and the pieces drawn
+ * from rng are the same. Larger boards are resolved by resolveSwapBoard.
+ */
+bool resolveSwapTotalsBoard( Board *board, Move move, Rng *rng, Cascade *cascade ) {
+
+    if ( board->width > BITBOARD_SIZE || board->height > BITBOARD_SIZE ) {
+        return resolveSwapBoard( board, move, rng, cascade );
+    }
+
+    clearCascade( cascade );
+
+    if ( !isSwapAllowed( board, move ) ) {
+        return false;
+    }
+
+    PieceType p1 = getPieceBoard( board, move.r1, move.c1 );
+    PieceType p2 = getPieceBoard( board, move.r2, move.c2 );
+    setPieceBoard( board, move.r1, move.c1, p2 );
+    setPieceBoard( board, move.r2, move.c2, p1 );
+
+    BitBoard bb;
+    loadBitBoard( &bb, board );
+    resolveTotalsBitBoard( board, &bb, rng, cascade );
+
+    if ( cascade->depth == 0 ) {
+        setPieceBoard( board, move.r1, move.c1, p1 );
+        setPieceBoard( board, move.r2, move.c2, p2 );
+        return false;
+    }
+
+    return true;
+
+}
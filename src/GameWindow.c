@@ -13,6 +13,10 @@
 #include "ResourceManager.h"
 #include "raylib/raylib.h"
 
+// a frame that took longer (a hitch, a dragged window) slows the falls
+// down instead of running a burst of steps to catch up
+#define MAX_STEPS_PER_FRAME 8
+
 /**
  * @brief Creates a dinamically allocated GameWindow struct instance.
  */
@@ -20,6 +24,8 @@ GameWindow* createGameWindow(
         int width, 
         int height, 
         const char *title, 
+        int boardWidth,
+        int boardHeight,
         int targetFPS,
         bool antialiasing, 
         bool resizable, 
@@ -36,6 +42,8 @@ GameWindow* createGameWindow(
     gameWindow->width = width;
     gameWindow->height = height;
     gameWindow->title = title;
+    gameWindow->boardWidth = boardWidth;
+    gameWindow->boardHeight = boardHeight;
     gameWindow->targetFPS = targetFPS;
     gameWindow->antialiasing = antialiasing;
     gameWindow->resizable = resizable;
@@ -103,12 +111,30 @@ void initGameWindow( GameWindow *gameWindow ) {
             loadResourcesResourceManager();
         }
 
-        gameWindow->gw = createGameWorld();
+        gameWindow->gw = createGameWorld( gameWindow->boardWidth, gameWindow->boardHeight );
+
+        // game loop: input once a frame, the simulation in fixed steps
+        // and the drawing in between the last two of them
+        const float step = 1.0f / GAME_STEPS_PER_SECOND;
+        float accumulator = 0;
 
-        // game loop
         while ( !WindowShouldClose() ) {
-            updateGameWorld( gameWindow->gw, GetFrameTime() );
-            drawGameWorld( gameWindow->gw );
+
+            float delta = GetFrameTime();
+            updateGameWorld( gameWindow->gw, delta );
+
+            accumulator += delta;
+            if ( accumulator > MAX_STEPS_PER_FRAME * step ) {
+                accumulator = MAX_STEPS_PER_FRAME * step;
+            }
+
+            while ( accumulator >= step ) {
+                stepGameWorld( gameWindow->gw, step );
+                accumulator -= step;
+            }
+
+            drawGameWorld( gameWindow->gw, accumulator / step );
+
         }
 
         if ( gameWindow->loadResources ) {
@@ -7,9 +7,17 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
 
 #include "GameWorld.h"
+#include "BitBoard.h"
+#include "Match.h"
+#include "Cascade.h"
+#include "BoardGenerator.h"
+#include "Puzzle.h"
 #include "ResourceManager.h"
 #include "Piece.h"
 
@@ -19,113 +27,104 @@
 //#include "raylib/raygui.h"       // other compilation units must only include
 //#undef RAYGUI_IMPLEMENTATION     // raygui.h
 
-#define LIST_CAPACITY 100
+#define REPLAY_FILE_PATH "replay.bin"
+#define BEST_HINT_DEPTH 3
+#define BEST_HINT_SAMPLES 4
+#define BEST_HINT_TABLE_BITS 16
+#define BEST_HINT_BUDGET_MICROSECONDS 2000
+#define PUZZLE_HINT_DEPTH 8
+#define MIN_PIECE_SIZE 12
+#define CAMERA_PIECES_PER_SECOND 20
+#define ANIMATION_ARENA_BLOCK_SIZE 4096
+#define FRAME_ARENA_BLOCK_SIZE ( 64 * 1024 )
+#define REFILL_CHUNK 64
 
-static int selectedCol;
-static int selectedRow;
-
-static Piece *selectedPiece = NULL;
-static Vector2 pressOffset;
-static Vector2 pressPos;
-static Vector2 mousePos;
-
-static Piece *leftNeighbor;
-static Piece *rightNeighbor;
-static Piece *topNeighbor;
-static Piece *downNeighbor;
-static Piece *beingSwapped;
-
-static Position positionList[LIST_CAPACITY];
-static int positionListSize = 0;
-
-static FallingPiece animationList[LIST_CAPACITY];
-static int animationListSize = 0;
 static const float BASE_FALL_SPEED = 100;
-static float fallSpeed = 0;
 static const float GRAVITY = 2000;
 
-static Position piecesToCheckPositionList[LIST_CAPACITY];
-static int piecesToCheckPositionListSize = 0;
-
-static int crossTest[] = {
-    1, 4, 1, 1, 1, 1, 4, 1,
-    1, 3, 1, 1, 1, 4, 4, 4,
-    4, 4, 4, 1, 1, 1, 3, 1,
-    1, 4, 1, 1, 1, 1, 4, 1,
-    1, 1, 1, 1, 1, 1, 1, 1,
-    1, 4, 1, 1, 1, 1, 4, 1,
-    4, 4, 3, 4, 4, 3, 4, 4,
-    1, 4, 1, 1, 1, 1, 4, 1
-};
-
-static int tTest[] = {
-    1, 4, 1, 1, 1, 4, 1, 1,
-    1, 4, 1, 1, 4, 3, 4, 1,
-    4, 3, 4, 1, 1, 4, 1, 1,
-    1, 4, 1, 1, 1, 4, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 4, 1, 1, 4, 1, 1,
-    4, 4, 3, 4, 4, 3, 4, 4,
-    1, 1, 4, 1, 1, 4, 1, 1
-};
-
-static int lTest[] = {
-    4, 1, 1, 1, 1, 1, 1, 4,
-    4, 1, 1, 1, 1, 1, 1, 4,
-    3, 4, 4, 1, 1, 4, 4, 3,
-    4, 1, 1, 1, 1, 1, 1, 4,
-    4, 1, 1, 1, 1, 1, 1, 4,
-    3, 4, 4, 1, 1, 4, 4, 3,
-    4, 1, 1, 1, 1, 1, 1, 4,
-    4, 1, 1, 1, 1, 1, 1, 4
-};
-
-static int linearTest[] = {
-    1, 1, 1, 1, 1, 1, 1, 1,
-    4, 1, 1, 1, 1, 1, 4, 1,
-    4, 1, 1, 1, 1, 4, 3, 1,
-    3, 4, 3, 4, 3, 1, 4, 1,
-    4, 1, 4, 3, 4, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 4, 1, 1, 1,
-    1, 1, 4, 4, 3, 4, 1, 1,
-};
-
-static int *piecesToUse = NULL;
-
-static bool checkValidityAndCommitChanges( GameWorld *gw, int r1, int c1, int r2, int c2 );
-static bool checkPiece( GameWorld *gw, int row, int col );
+static SwapSpeculation *findSpeculation( GameWorld *gw, int r2, int c2 );
+static void prepareSpeculations( GameWorld *gw );
+static void advanceSpeculations( GameWorld *gw );
+static void resolveSpeculation( GameWorld *gw, SwapSpeculation *spec );
+static void commitSpeculation( GameWorld *gw, SwapSpeculation *spec );
+static bool checkMatches( GameWorld *gw );
 static void processMatches( GameWorld *gw );
-static void buildGrid( GameWorld *gw, int *pieces );
+static void resizeGrid( GameWorld *gw, int width, int height );
+static void freeGrid( GameWorld *gw );
+static void buildGrid( GameWorld *gw, const Board *puzzle );
+static int cellAt( GameWorld *gw, int row, int col );
+static Vector2 piecePosition( GameWorld *gw, int cell );
+static void drawCell( GameWorld *gw, int cell, int padding );
+static void clearSelection( GameWorld *gw );
+static bool fitsBitBoard( GameWorld *gw );
+static ThreadPool *tiledPool( GameWorld *gw );
+static void markChanged( GameWorld *gw, int row, int col );
+static void updateCamera( GameWorld *gw, float delta );
+static void drawMoveOutline( GameWorld *gw, Move move, Color color );
+
+static void refreshMoveSet( GameWorld *gw, uint64_t changed );
+static void startHintSearch( GameWorld *gw, const Board *board );
+static void startPuzzleHint( GameWorld *gw );
+static void followPuzzleSolution( GameWorld *gw, Move move );
+static void reshuffleGrid( GameWorld *gw );
+
+static void animationListAdd( GameWorld *gw, int cell );
+static void animationListClear( GameWorld *gw );
 
-static void positionListAdd( int row, int col );
-static void positionListClear( void );
-static void positionListUncheckAndClear( GameWorld *gw );
-
-static void animationListAdd( Piece *p, float targetY );
-static void animationListClear( void );
+static void resetGrid( GameWorld *gw ) {
 
-static void piecesToCheckPositionListAdd( int row, int col );
-static void piecesToCheckPositionListClear( void );
+    seedRng( &gw->rng, gw->seed, 0 );
+    clearReplay( gw->replay, gw->seed );
+
+    if ( gw->puzzleIndex >= 0 ) {
+        resizeGrid( gw, PUZZLE_SIZE, PUZZLE_SIZE );
+        gw->puzzleName = loadBuiltinPuzzle( gw->puzzleIndex, gw->board, &gw->puzzleGoal );
+        buildGrid( gw, gw->board );
+        startPuzzleHint( gw );
+    } else {
+        resizeGrid( gw, gw->gameWidth, gw->gameHeight );
+        buildGrid( gw, NULL );
+    }
 
-static void resetGrid( GameWorld *gw ) {
-    buildGrid( gw, piecesToUse );
     gw->state = GAME_STATE_PLAYING;
-    positionListClear();
-    animationListClear();
+    animationListClear( gw );
+    refreshMoveSet( gw, ~0ULL );
+    gw->speculationCount = 0;
+    gw->showBestHint = false;
+
+    startHintSearch( gw, gw->board );
+
 }
 
 /**
- * @brief Creates a dinamically allocated GameWorld struct instance.
+ * @brief Creates a dinamically allocated GameWorld struct instance, with
+ * regular games played on boards of width x height pieces (clamped from
+ * GAME_MIN_SIZE up to BOARD_MAX_SIZE).
  */
-GameWorld* createGameWorld( void ) {
+GameWorld* createGameWorld( int width, int height ) {
 
     GameWorld *gw = (GameWorld*) calloc( 1, sizeof( GameWorld ) );
     gw->background = (Color){ 80, 49, 47, 255 };
     gw->detail = (Color){ 75, 45, 47, 255 };
-    gw->pieceSize = GetScreenWidth() / GRID_WIDTH;
+    gw->gameWidth = width < GAME_MIN_SIZE ? GAME_MIN_SIZE : width > BOARD_MAX_SIZE ? BOARD_MAX_SIZE : width;
+    gw->gameHeight = height < GAME_MIN_SIZE ? GAME_MIN_SIZE : height > BOARD_MAX_SIZE ? BOARD_MAX_SIZE : height;
     gw->pieceMargin = 1;
     gw->state = GAME_STATE_PLAYING;
+    gw->seed = (uint64_t) time( NULL );
+    gw->frame = 0;
+    gw->puzzleIndex = -1;
+    gw->replay = createReplay( gw->seed, gw->gameWidth, gw->gameHeight );
+    gw->searchTable = createTranspositionTable( BEST_HINT_TABLE_BITS, BITBOARD_SIZE );
+    gw->hintBudget = BEST_HINT_BUDGET_MICROSECONDS;
+    initAnytimeSearch( &gw->hintSearch, (SearchConfig) { BEST_HINT_DEPTH, BEST_HINT_SAMPLES, 0 }, gw->searchTable );
+
+    if ( gw->gameWidth * gw->gameHeight >= GAME_TILED_CELLS ) {
+        gw->pool = createThreadPool( 0 );
+    }
+
+    gw->animationArena = createArena( ANIMATION_ARENA_BLOCK_SIZE );
+    gw->frameArena = createArena( FRAME_ARENA_BLOCK_SIZE );
+    initArenaList( &gw->animationList, gw->animationArena, sizeof( int ) );
     
     resetGrid( gw );
 
@@ -137,6 +136,19 @@ GameWorld* createGameWorld( void ) {
  * @brief Destroys a GameWindow object and its dependecies.
  */
 void destroyGameWorld( GameWorld *gw ) {
+    freeGrid( gw );
+    TraceLog( LOG_INFO, "arena high-water marks: %zu bytes animating, %zu bytes per frame",
+              gw->animationArena->highWater, gw->frameArena->highWater );
+    destroyArena( gw->animationArena );
+    destroyArena( gw->frameArena );
+    destroyTranspositionTable( gw->searchTable );
+    if ( gw->puzzleTable != NULL ) {
+        destroyTranspositionTable( gw->puzzleTable );
+    }
+    destroyReplay( gw->replay );
+    if ( gw->pool != NULL ) {
+        destroyThreadPool( gw->pool );
+    }
     free( gw );
 }
 
@@ -145,306 +157,294 @@ void destroyGameWorld( GameWorld *gw ) {
  */
 void updateGameWorld( GameWorld *gw, float delta ) {
 
+    gw->frame++;
+    resetArena( gw->frameArena );
+    updateCamera( gw, delta );
+
+    if ( IsKeyPressed( KEY_S ) ) {
+        if ( saveReplay( gw->replay, REPLAY_FILE_PATH ) ) {
+            TraceLog( LOG_INFO, "replay saved to %s (%d moves)", REPLAY_FILE_PATH, gw->replay->moveCount );
+        } else {
+            TraceLog( LOG_WARNING, "could not save the replay to %s", REPLAY_FILE_PATH );
+        }
+    }
+
     if ( IsKeyPressed( KEY_R ) ) {
+        // the next board seed comes from the current one, so a session is
+        // fully reproducible from its first seed
+        gw->seed = ( (uint64_t) nextRng( &gw->rng ) << 32 ) | nextRng( &gw->rng );
         resetGrid( gw );
     }
 
-    if ( gw->state == GAME_STATE_PLAYING ) {   
+    if ( IsKeyPressed( KEY_H ) ) {
+        gw->showHint = !gw->showHint;
+    }
 
-        if ( selectedPiece == NULL ) {
+    if ( IsKeyPressed( KEY_B ) ) {
+        if ( gw->puzzleIndex < 0 ) {
+            gw->showBestHint = !gw->showBestHint;
+        } else if ( gw->puzzleSolve.solution.solved && gw->puzzleSolve.solution.moveCount > 0 ) {
+            gw->showBestHint = !gw->showBestHint;
+        }
+    }
 
-            if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
+    // the best hint is refined a little every frame, animations included,
+    // without ever taking more than its budget of the frame
+    if ( gw->puzzleIndex < 0 && !gw->hintSearch.finished &&
+         stepAnytimeSearch( &gw->hintSearch, gw->hintBudget ) ) {
+        TraceLog( LOG_INFO, "best hint: %.1f cells expected at depth %d, %lld nodes, %lld table hits",
+                  gw->hintSearch.best.expectedScore, gw->hintSearch.best.depth,
+                  gw->hintSearch.best.nodes, gw->hintSearch.best.tableHits );
+    }
 
-                pressPos = GetMousePosition();
-                mousePos = pressPos;
+    // and so is the puzzle solution, which is only shown once found
+    if ( gw->puzzleIndex >= 0 && !gw->puzzleSolve.finished &&
+         stepAnytimePuzzle( &gw->puzzleSolve, gw->hintBudget ) ) {
+        PuzzleSolution *solution = &gw->puzzleSolve.solution;
+        TraceLog( LOG_INFO, "puzzle %s: %s, %d swaps, %lld nodes in %.2f ms", gw->puzzleName,
+                  solution->solved ? "solved" : solution->unsolvable ? "unsolvable" : "not solved",
+                  solution->moveCount, solution->nodes, solution->microseconds / 1000.0 );
+    }
 
-                selectedCol = pressPos.x / gw->pieceSize;
-                selectedRow = pressPos.y / gw->pieceSize;
+    // 1 to 4 load the built-in puzzles, 0 goes back to the regular game
+    for ( int i = 0; i <= PUZZLE_BUILTIN_COUNT; i++ ) {
+        if ( IsKeyPressed( KEY_ZERO + i ) ) {
+            gw->puzzleIndex = i - 1;
+            resetGrid( gw );
+        }
+    }
 
-                selectedPiece = &gw->grid[selectedRow][selectedCol];
-                selectedPiece->selected = true;
+    if ( gw->state == GAME_STATE_PLAYING ) {   
 
-                pressOffset.x = pressPos.x - selectedPiece->pos.x;
-                pressOffset.y = pressPos.y - selectedPiece->pos.y;
+        if ( gw->selectedCell == -1 ) {
 
-                int leftCol = selectedCol - 1;
-                int rightCol = selectedCol + 1;
-                int topRow = selectedRow - 1;
-                int downRow = selectedRow + 1;
+            // positions are in world coordinates: the board may be scrolled
+            Vector2 pressPos = GetScreenToWorld2D( GetMousePosition(), gw->camera );
 
-                leftNeighbor = leftCol >= 0 ? &gw->grid[selectedRow][leftCol] : NULL;
-                rightNeighbor = rightCol < GRID_WIDTH ? &gw->grid[selectedRow][rightCol] : NULL;
-                topNeighbor = topRow >= 0 ? &gw->grid[topRow][selectedCol] : NULL;
-                downNeighbor = downRow < GRID_HEIGHT ? &gw->grid[downRow][selectedCol] : NULL;
+            if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) &&
+                 pressPos.x >= 0 && pressPos.x < gw->width * gw->pieceSize &&
+                 pressPos.y >= 0 && pressPos.y < gw->height * gw->pieceSize ) {
 
-                if ( leftNeighbor != NULL ) {
-                    leftNeighbor->selected = true;
-                    leftNeighbor->pos.x = ( selectedCol - 1 ) * selectedPiece->dim.x;
-                    leftNeighbor->pos.y = selectedRow * selectedPiece->dim.x;
-                }
+                gw->pressPos = pressPos;
+                gw->mousePos = gw->pressPos;
 
-                if ( rightNeighbor != NULL ) {
-                    rightNeighbor->selected = true;
-                    rightNeighbor->pos.x = ( selectedCol + 1 ) * selectedPiece->dim.x;
-                    rightNeighbor->pos.y = selectedRow * selectedPiece->dim.x;
-                }
+                gw->selectedCol = gw->pressPos.x / gw->pieceSize;
+                gw->selectedRow = gw->pressPos.y / gw->pieceSize;
+                gw->selectedCell = cellAt( gw, gw->selectedRow, gw->selectedCol );
 
-                if ( topNeighbor != NULL ) {
-                    topNeighbor->selected = true;
-                    topNeighbor->pos.x = selectedCol * selectedPiece->dim.y;
-                    topNeighbor->pos.y = ( selectedRow - 1 ) * selectedPiece->dim.y;
-                }
+                gw->leftNeighbor = gw->selectedCol > 0 ? gw->selectedCell - 1 : -1;
+                gw->rightNeighbor = gw->selectedCol + 1 < gw->width ? gw->selectedCell + 1 : -1;
+                gw->topNeighbor = gw->selectedRow > 0 ? gw->selectedCell - gw->width : -1;
+                gw->downNeighbor = gw->selectedRow + 1 < gw->height ? gw->selectedCell + gw->width : -1;
+
+                int dragged[5] = { gw->selectedCell, gw->leftNeighbor, gw->rightNeighbor, gw->topNeighbor, gw->downNeighbor };
 
-                if ( downNeighbor != NULL ) {
-                    downNeighbor->selected = true;
-                    downNeighbor->pos.x = selectedCol * selectedPiece->dim.y;
-                    downNeighbor->pos.y = ( selectedRow + 1 ) * selectedPiece->dim.y;
+                for ( int i = 0; i < 5; i++ ) {
+                    if ( dragged[i] != -1 ) {
+                        gw->pieceFlags[dragged[i]] |= PIECE_FLAG_SELECTED;
+                        gw->pieceOffsets[dragged[i]] = (Vector2) { 0, 0 };
+                    }
                 }
 
+                prepareSpeculations( gw );
+
             }
 
         } else {
 
-            mousePos = GetMousePosition();
+            gw->mousePos = GetScreenToWorld2D( GetMousePosition(), gw->camera );
 
-            selectedPiece->pos.x = mousePos.x - pressOffset.x;
-            selectedPiece->pos.y = mousePos.y - pressOffset.y;
+            float xDiff = gw->mousePos.x - gw->pressPos.x;
+            float yDiff = gw->mousePos.y - gw->pressPos.y;
+            float size = gw->pieceSize;
 
-            float xDiff = mousePos.x - pressPos.x;
-            float yDiff = mousePos.y - pressPos.y;
+            // the selected piece follows the mouse along the main direction
+            // of the drag, up to the neighbor cell (or the border of the board)
+            Vector2 offset = { 0, 0 };
 
             if ( fabs( xDiff ) >= fabs( yDiff ) ) {
-                selectedPiece->pos.y = selectedRow * selectedPiece->dim.y;
+                offset.x = fmin( fmax( xDiff, gw->leftNeighbor != -1 ? -size : 0 ), gw->rightNeighbor != -1 ? size : 0 );
             } else {
-                selectedPiece->pos.x = selectedCol * selectedPiece->dim.x;
+                offset.y = fmin( fmax( yDiff, gw->topNeighbor != -1 ? -size : 0 ), gw->downNeighbor != -1 ? size : 0 );
             }
 
-            if ( leftNeighbor != NULL ) {
-                if ( selectedPiece->pos.x < ( selectedCol - 1 ) * selectedPiece->dim.x ) {
-                    selectedPiece->pos.x = ( selectedCol - 1 ) * selectedPiece->dim.x;
-                }
-            } else {
-                if ( selectedPiece->pos.x < 0 ) {
-                    selectedPiece->pos.x = 0;
-                }
-            }
+            gw->pieceOffsets[gw->selectedCell] = offset;
 
-            if ( rightNeighbor != NULL ) {
-                if ( selectedPiece->pos.x > ( selectedCol + 1 ) * selectedPiece->dim.x ) {
-                    selectedPiece->pos.x = ( selectedCol + 1 ) * selectedPiece->dim.x;
-                }
-            } else {
-                if ( selectedPiece->pos.x + selectedPiece->dim.x > GetScreenWidth() ) {
-                    selectedPiece->pos.x = GetScreenWidth() - selectedPiece->dim.x;
-                }
-            }
+            // the neighbors stay at their cells, but the one being swapped
+            // moves the other way
+            int neighbors[4] = { gw->leftNeighbor, gw->rightNeighbor, gw->topNeighbor, gw->downNeighbor };
 
-            if ( topNeighbor != NULL ) {
-                if ( selectedPiece->pos.y < ( selectedRow - 1 ) * selectedPiece->dim.y ) {
-                    selectedPiece->pos.y = ( selectedRow - 1 ) * selectedPiece->dim.y;
+            for ( int i = 0; i < 4; i++ ) {
+                if ( neighbors[i] != -1 ) {
+                    gw->pieceOffsets[neighbors[i]] = (Vector2) { 0, 0 };
                 }
-            } else {
-                if ( selectedPiece->pos.y < 0 ) {
-                    selectedPiece->pos.y = 0;
-                }
-            }
-
-            if ( downNeighbor != NULL ) {
-                if ( selectedPiece->pos.y > ( selectedRow + 1 ) * selectedPiece->dim.y ) {
-                    selectedPiece->pos.y = ( selectedRow + 1 ) * selectedPiece->dim.y;
-                }
-            } else {
-                if ( selectedPiece->pos.y + selectedPiece->dim.y > GetScreenHeight() ) {
-                    selectedPiece->pos.y = GetScreenHeight() - selectedPiece->dim.y;
-                }
-            }
-
-            if ( leftNeighbor != NULL ) {
-                leftNeighbor->pos.x = ( selectedCol - 1 ) * selectedPiece->dim.x;
-                leftNeighbor->pos.y = selectedRow * selectedPiece->dim.x;
-            }
-
-            if ( rightNeighbor != NULL ) {
-                rightNeighbor->pos.x = ( selectedCol + 1 ) * selectedPiece->dim.x;
-                rightNeighbor->pos.y = selectedRow * selectedPiece->dim.x;
-            }
-
-            if ( topNeighbor != NULL ) {
-                topNeighbor->pos.x = selectedCol * selectedPiece->dim.y;
-                topNeighbor->pos.y = ( selectedRow - 1 ) * selectedPiece->dim.y;
-            }
-
-            if ( downNeighbor != NULL ) {
-                downNeighbor->pos.x = selectedCol * selectedPiece->dim.y;
-                downNeighbor->pos.y = ( selectedRow + 1 ) * selectedPiece->dim.y;
             }
 
             if ( fabs( xDiff ) >= fabs( yDiff ) ) {
-                float xOffset = selectedPiece->pos.x - selectedCol * selectedPiece->dim.x;
                 if ( xDiff < 0 ) {
-                    if ( leftNeighbor != NULL ) {
-                        leftNeighbor->pos.x = ( selectedCol - 1 ) * selectedPiece->dim.x - xOffset;
-                        beingSwapped = leftNeighbor;
+                    if ( gw->leftNeighbor != -1 ) {
+                        gw->pieceOffsets[gw->leftNeighbor].x = -offset.x;
+                        gw->beingSwapped = gw->leftNeighbor;
                     }
                 } else if ( xDiff > 0 ) {
-                    if ( rightNeighbor != NULL ) {
-                        rightNeighbor->pos.x = ( selectedCol + 1 ) * selectedPiece->dim.x - xOffset;
-                        beingSwapped = rightNeighbor;
+                    if ( gw->rightNeighbor != -1 ) {
+                        gw->pieceOffsets[gw->rightNeighbor].x = -offset.x;
+                        gw->beingSwapped = gw->rightNeighbor;
                     }
                 } else {
-                    beingSwapped = NULL;
+                    gw->beingSwapped = -1;
                 }
             } else {
-                float yOffset = selectedPiece->pos.y - selectedRow * selectedPiece->dim.y;
                 if ( yDiff < 0 ) {
-                    if ( topNeighbor != NULL ) {
-                        topNeighbor->pos.y = ( selectedRow - 1 ) * selectedPiece->dim.y - yOffset;
-                        beingSwapped = topNeighbor;
+                    if ( gw->topNeighbor != -1 ) {
+                        gw->pieceOffsets[gw->topNeighbor].y = -offset.y;
+                        gw->beingSwapped = gw->topNeighbor;
                     }
                 } else if ( yDiff > 0 ) {
-                    if ( downNeighbor != NULL ) {
-                        downNeighbor->pos.y = ( selectedRow + 1 ) * selectedPiece->dim.y - yOffset;
-                        beingSwapped = downNeighbor;
+                    if ( gw->downNeighbor != -1 ) {
+                        gw->pieceOffsets[gw->downNeighbor].y = -offset.y;
+                        gw->beingSwapped = gw->downNeighbor;
                     }
                 } else {
-                    beingSwapped = NULL;
+                    gw->beingSwapped = -1;
                 }
             }
 
+            advanceSpeculations( gw );
+
         }
         
     }
 
     if ( IsMouseButtonReleased( MOUSE_BUTTON_LEFT ) ) {
 
-        if ( selectedPiece != NULL ) {
-            selectedPiece->selected = false;
-            selectedPiece->pos.x = selectedCol * selectedPiece->dim.x;
-            selectedPiece->pos.y = selectedRow * selectedPiece->dim.y;
-        }
-
-        if ( leftNeighbor != NULL ) {
-            leftNeighbor->selected = false;
-            leftNeighbor->pos.x = ( selectedCol - 1 ) * selectedPiece->dim.x;
-            leftNeighbor->pos.y = selectedRow * selectedPiece->dim.x;
-        }
-
-        if ( rightNeighbor != NULL ) {
-            rightNeighbor->selected = false;
-            rightNeighbor->pos.x = ( selectedCol + 1 ) * selectedPiece->dim.x;
-            rightNeighbor->pos.y = selectedRow * selectedPiece->dim.x;
-        }
+        // the dragged pieces go back to their cells
+        int dragged[5] = { gw->selectedCell, gw->leftNeighbor, gw->rightNeighbor, gw->topNeighbor, gw->downNeighbor };
 
-        if ( topNeighbor != NULL ) {
-            topNeighbor->selected = false;
-            topNeighbor->pos.x = selectedCol * selectedPiece->dim.y;
-            topNeighbor->pos.y = ( selectedRow - 1 ) * selectedPiece->dim.y;
+        for ( int i = 0; i < 5; i++ ) {
+            if ( dragged[i] != -1 ) {
+                gw->pieceFlags[dragged[i]] &= ~PIECE_FLAG_SELECTED;
+                gw->pieceOffsets[dragged[i]] = (Vector2) { 0, 0 };
+            }
         }
 
-        if ( downNeighbor != NULL ) {
-            downNeighbor->selected = false;
-            downNeighbor->pos.x = selectedCol * selectedPiece->dim.y;
-            downNeighbor->pos.y = ( selectedRow + 1 ) * selectedPiece->dim.y;
-        }
+        if ( gw->beingSwapped != -1 ) {
 
-        if ( beingSwapped != NULL ) {
-
-            int r2 = 0;
-            int c2 = 0;
-
-            if ( beingSwapped == leftNeighbor ) {
-                r2 = selectedRow;
-                c2 = selectedCol - 1;
-            } else if ( beingSwapped == rightNeighbor ) {
-                r2 = selectedRow;
-                c2 = selectedCol + 1;
-            } else if ( beingSwapped == topNeighbor ) {
-                r2 = selectedRow - 1;
-                c2 = selectedCol;
-            } else if ( beingSwapped == downNeighbor ) {
-                r2 = selectedRow + 1;
-                c2 = selectedCol;
-            }
+            int r2 = gw->beingSwapped / gw->width;
+            int c2 = gw->beingSwapped % gw->width;
 
-            Vector2 p1 = gw->grid[selectedRow][selectedCol].pos;
-            Vector2 p2 = gw->grid[r2][c2].pos;
+            // the swap was resolved while dragging (or is resolved now, if
+            // the release came first): an invalid swap is simply not made
+            SwapSpeculation *spec = findSpeculation( gw, r2, c2 );
+            resolveSpeculation( gw, spec );
 
-            gw->grid[selectedRow][selectedCol].pos = p2;
-            gw->grid[r2][c2].pos = p1;
+            if ( spec->valid ) {
 
-            Piece p = gw->grid[selectedRow][selectedCol];
-            gw->grid[selectedRow][selectedCol] = gw->grid[r2][c2];
-            gw->grid[r2][c2] = p;
+                // both pieces are back at their cells, so only their types
+                // and flags change places
+                int a = gw->selectedCell;
+                int b = gw->beingSwapped;
 
-            if ( !checkValidityAndCommitChanges( gw, r2, c2, selectedRow, selectedCol ) ) {
+                uint8_t type = gw->board->cells[a];
+                gw->board->cells[a] = gw->board->cells[b];
+                gw->board->cells[b] = type;
 
-                // rollback changes if not valid
-                //TraceLog( LOG_INFO, "rolling back..." );
+                uint8_t flags = gw->pieceFlags[a];
+                gw->pieceFlags[a] = gw->pieceFlags[b];
+                gw->pieceFlags[b] = flags;
 
-                p1 = gw->grid[selectedRow][selectedCol].pos;
-                p2 = gw->grid[r2][c2].pos;
+                commitSpeculation( gw, spec );
 
-                gw->grid[selectedRow][selectedCol].pos = p2;
-                gw->grid[r2][c2].pos = p1;
-
-                p = gw->grid[selectedRow][selectedCol];
-                gw->grid[selectedRow][selectedCol] = gw->grid[r2][c2];
-                gw->grid[r2][c2] = p;
+                // replays start from generated boards, puzzles are not recorded
+                if ( gw->puzzleIndex < 0 ) {
+                    addMoveReplay( gw->replay, gw->frame, spec->move );
+                } else {
+                    followPuzzleSolution( gw, spec->move );
+                }
 
             }
             
         }
 
-        selectedPiece = NULL;
-        leftNeighbor = NULL;
-        rightNeighbor = NULL;
-        topNeighbor = NULL;
-        downNeighbor = NULL;
-        beingSwapped = NULL;
+        clearSelection( gw );
 
     }
 
-    if ( gw->state == GAME_STATE_DROPPING_NEW_PIECES ) {
-        int ok = 0;
-        for ( int i = 0; i < animationListSize; i++ ) {
-            if ( animationList[i].piece->pos.y < animationList[i].targetY ) {
-                animationList[i].piece->pos.y += fallSpeed * delta;
-            } else {
-                animationList[i].piece->pos.y = animationList[i].targetY;
-                ok++;
-            }
+}
+
+/**
+ * @brief Advances the falling pieces by one simulation step of step
+ * seconds. Called at a fixed rate (GAME_STEPS_PER_SECOND), whatever the
+ * frame rate is, the falls take the same steps on every machine.
+ */
+void stepGameWorld( GameWorld *gw, float step ) {
+
+    if ( gw->state != GAME_STATE_DROPPING_NEW_PIECES ) {
+        return;
+    }
+
+    int *cells = (int*) gw->animationList.items;
+    int ok = 0;
+
+    for ( int i = 0; i < gw->animationList.count; i++ ) {
+        int cell = cells[i];
+        Vector2 *offset = &gw->pieceOffsets[cell];
+        gw->lastFallOffsets[cell] = offset->y;
+        if ( offset->y < 0 ) {
+            offset->y += gw->fallSpeed * step;
+        } else {
+            offset->y = 0;
+            gw->pieceFlags[cell] &= ~PIECE_FLAG_FALLING;
+            ok++;
         }
-        if ( ok == animationListSize ) {
-            animationListClear();
-            // verifying new matches for new pieces
-            bool newMatches = false;
-            for ( int i = 0; i < piecesToCheckPositionListSize; i++ ) {
-                if ( checkPiece( gw, piecesToCheckPositionList[i].row, piecesToCheckPositionList[i].col ) ) {
-                    newMatches = true;
-                }
+    }
+
+    if ( ok == gw->animationList.count ) {
+        animationListClear( gw );
+        // verifying new matches after the fall
+        if ( checkMatches( gw ) ) {
+            processMatches( gw );
+        } else {
+            gw->state = GAME_STATE_PLAYING;
+            refreshMoveSet( gw, gw->changedCells );
+            gw->changedCells = 0;
+            if ( !gw->hasMoves && gw->puzzleIndex < 0 ) {
+                reshuffleGrid( gw );
             }
-            if ( newMatches ) {
-                piecesToCheckPositionListClear();
-                processMatches( gw );
-            } else {
-                gw->state = GAME_STATE_PLAYING;
+            if ( gw->puzzleIndex >= 0 && !gw->puzzleSolve.solution.solved ) {
+                startPuzzleHint( gw );
             }
         }
-        fallSpeed += GRAVITY * delta;
     }
 
+    gw->fallSpeed += GRAVITY * step;
+
 }
 
 /**
- * @brief Draws the state of the game.
+ * @brief Draws the state of the game, with the falling pieces alpha
+ * (from 0 to 1) of the way from where they were at the step before the
+ * last one to where they are now.
  */
-void drawGameWorld( GameWorld *gw ) {
+void drawGameWorld( GameWorld *gw, float alpha ) {
+
+    gw->stepAlpha = alpha;
 
     BeginDrawing();
     ClearBackground( gw->background );
-
-    for ( int i = 0; i < GRID_HEIGHT; i++ ) {
-        for ( int j = 0; j < GRID_WIDTH; j++ ) {
+    BeginMode2D( gw->camera );
+
+    // only the cells inside the window are drawn
+    Vector2 topLeft = GetScreenToWorld2D( (Vector2) { 0, 0 }, gw->camera );
+    Vector2 bottomRight = GetScreenToWorld2D( (Vector2) { GetScreenWidth(), GetScreenHeight() }, gw->camera );
+    int firstRow = fmax( 0, floor( topLeft.y / gw->pieceSize ) );
+    int firstCol = fmax( 0, floor( topLeft.x / gw->pieceSize ) );
+    int lastRow = fmin( gw->height - 1, floor( bottomRight.y / gw->pieceSize ) );
+    int lastCol = fmin( gw->width - 1, floor( bottomRight.x / gw->pieceSize ) );
+    int padding = gw->pieceSize * 6 / 100;
+
+    for ( int i = firstRow; i <= lastRow; i++ ) {
+        for ( int j = firstCol; j <= lastCol; j++ ) {
             if ( ( i + j ) % 2 != 0 ) {
                 DrawRectangleRounded( 
                     (Rectangle) {
@@ -461,539 +461,572 @@ void drawGameWorld( GameWorld *gw ) {
         }
     }
 
-    for ( int i = 0; i < GRID_HEIGHT; i++ ) {
-        for ( int j = 0; j < GRID_WIDTH; j++ ) {
-            Piece *p = &gw->grid[i][j];
-            if ( p != selectedPiece ) {
-                drawPiece( p, 6 );
+    for ( int i = firstRow; i <= lastRow; i++ ) {
+        for ( int j = firstCol; j <= lastCol; j++ ) {
+            int cell = cellAt( gw, i, j );
+            if ( cell != gw->selectedCell ) {
+                drawCell( gw, cell, padding );
             }
         }
     }
 
-    if ( selectedPiece != NULL ) {
-        drawPiece( selectedPiece, 6 );
+    // pieces falling to cells below the window may still cross it
+    for ( int i = 0; i < gw->animationList.count; i++ ) {
+        int cell = ( (int*) gw->animationList.items )[i];
+        Vector2 pos = piecePosition( gw, cell );
+        if ( cell / gw->width > lastRow &&
+             pos.y < bottomRight.y && pos.x + gw->pieceSize > topLeft.x && pos.x < bottomRight.x ) {
+            drawCell( gw, cell, padding );
+        }
     }
 
-    EndDrawing();
-
-}
+    if ( gw->selectedCell != -1 ) {
+        drawCell( gw, gw->selectedCell, padding );
+    }
 
-static bool checkCross( GameWorld *gw, int row, int col ) {
+    // instant feedback while dragging: green if releasing here makes a
+    // match, red if the pieces would go back
+    if ( gw->selectedCell != -1 && gw->beingSwapped != -1 ) {
+        for ( int i = 0; i < gw->speculationCount; i++ ) {
+            SwapSpeculation *spec = &gw->speculations[i];
+            if ( spec->resolved && cellAt( gw, spec->move.r2, spec->move.c2 ) == gw->beingSwapped ) {
+                drawMoveOutline( gw, spec->move, spec->valid ? GREEN : RED );
+            }
+        }
+    }
 
-    Piece (*grid)[GRID_HEIGHT] = gw->grid;
-    int type = grid[row][col].type;
+    bool puzzle = gw->puzzleIndex >= 0;
+    bool showBest = gw->state == GAME_STATE_PLAYING && gw->showBestHint && gw->selectedCell == -1 &&
+                    ( puzzle ? gw->puzzleSolve.solution.solved && gw->puzzleSolve.solution.moveCount > 0 :
+                               gw->hintSearch.best.found );
 
-    int left = 0;
-    int right = 0;
-    int top = 0;
-    int down = 0;
+    if ( gw->state == GAME_STATE_PLAYING ) {
 
-    // left
-    for ( int c = col - 1; c >= 0; c-- ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            left++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
+        if ( gw->showHint && gw->selectedCell == -1 && gw->hasMoves ) {
+            drawMoveOutline( gw, gw->firstMove, WHITE );
         }
-    }
 
-    if ( left == 2 && right == 0 && top == 0 && down == 0 && row > 0 && row < GRID_HEIGHT - 1 ) {
-        if ( grid[row-1][col-1].type == type && grid[row+1][col-1].type == type ) {
-            grid[row][col].checked = true;
-            grid[row-1][col-1].checked = true;
-            grid[row+1][col-1].checked = true;
-            positionListAdd( row, col );
-            positionListAdd( row-1, col-1 );
-            positionListAdd( row+1, col-1 );
-            return true;
+        if ( showBest ) {
+            drawMoveOutline( gw, puzzle ? gw->puzzleSolve.solution.moves[0] : gw->hintSearch.best.move, GOLD );
         }
-    }
 
-    // right
-    for ( int c = col + 1; c < GRID_WIDTH; c++ ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            right++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
-        }
     }
 
-    if ( right == 2 && left == 0 && top == 0 && down == 0 && row > 0 && row < GRID_HEIGHT - 1 ) {
-        if ( grid[row-1][col+1].type == type && grid[row+1][col+1].type == type ) {
-            grid[row][col].checked = true;
-            grid[row-1][col+1].checked = true;
-            grid[row+1][col+1].checked = true;
-            positionListAdd( row, col );
-            positionListAdd( row-1, col+1 );
-            positionListAdd( row+1, col+1 );
-            return true;
-        }
-    }
+    EndMode2D();
 
-    // top
-    for ( int r = row - 1; r >= 0; r-- ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            top++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
+    if ( showBest ) {
+        if ( !puzzle ) {
+            DrawText( TextFormat( "best: %.1f cells expected (depth %d of %d)", gw->hintSearch.best.expectedScore,
+                                  gw->hintSearch.best.depth, gw->hintSearch.maxDepth ), 10, 10, 20, GOLD );
         } else {
-            break;
+            DrawText( TextFormat( "solution: %d swaps left", gw->puzzleSolve.solution.moveCount ), 10, 10, 20, GOLD );
         }
     }
 
-    if ( top == 2 && down == 0 && left == 0 && right == 0 && col > 0 && col < GRID_WIDTH - 1 ) {
-        if ( grid[row-1][col-1].type == type && grid[row-1][col+1].type == type ) {
-            grid[row][col].checked = true;
-            grid[row-1][col-1].checked = true;
-            grid[row-1][col+1].checked = true;
-            positionListAdd( row, col );
-            positionListAdd( row-1, col-1 );
-            positionListAdd( row-1, col+1 );
-            return true;
-        }
-    }
+    if ( puzzle ) {
+
+        const char *goal = gw->puzzleGoal.type == PUZZLE_GOAL_EMPTY_BOARD ?
+                           "empty the board" : TextFormat( "clear color %d", gw->puzzleGoal.color );
+
+        DrawText( TextFormat( "puzzle %s: %s%s", gw->puzzleName, goal,
+                              isSolvedPuzzle( gw->board, gw->puzzleGoal ) ? " - solved!" : "" ),
+                  10, GetScreenHeight() - 30, 20, WHITE );
 
-    // down
-    for ( int r = row + 1; r < GRID_HEIGHT; r++ ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            down++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
-        }
     }
 
-    if ( down == 2 && top == 0 && left == 0 && right == 0 && col > 0 && col < GRID_WIDTH - 1 ) {
-        if ( grid[row+1][col-1].type == type && grid[row+1][col+1].type == type ) {
-            grid[row][col].checked = true;
-            grid[row+1][col-1].checked = true;
-            grid[row+1][col+1].checked = true;
-            positionListAdd( row, col );
-            positionListAdd( row+1, col-1 );
-            positionListAdd( row+1, col+1 );
-            return true;
+    EndDrawing();
+
+}
+
+static SwapSpeculation *findSpeculation( GameWorld *gw, int r2, int c2 ) {
+
+    for ( int i = 0; i < gw->speculationCount; i++ ) {
+        if ( gw->speculations[i].move.r2 == r2 && gw->speculations[i].move.c2 == c2 ) {
+            return &gw->speculations[i];
         }
     }
 
-    positionListUncheckAndClear( gw );
-    return false;
+    // not prepared (the grid was reset while dragging): resolved on demand
+    SwapSpeculation *spec = &gw->speculations[gw->speculationCount++];
+    spec->move = (Move) { gw->selectedRow, gw->selectedCol, r2, c2 };
+    spec->resolved = false;
+
+    return spec;
 
 }
 
-static bool checkT( GameWorld *gw, int row, int col ) {
+static void prepareSpeculations( GameWorld *gw ) {
 
-    Piece (*grid)[GRID_HEIGHT] = gw->grid;
-    int type = grid[row][col].type;
+    int neighbors[4] = { gw->leftNeighbor, gw->rightNeighbor, gw->topNeighbor, gw->downNeighbor };
+    int dr[4] = { 0, 0, -1, 1 };
+    int dc[4] = { -1, 1, 0, 0 };
 
-    int left = 0;
-    int right = 0;
-    int top = 0;
-    int down = 0;
+    gw->speculationCount = 0;
 
-    for ( int c = col - 1; c >= 0; c-- ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            left++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
+    for ( int i = 0; i < 4; i++ ) {
+        if ( neighbors[i] != -1 ) {
+            // the match list and settled board of each slot are kept
+            SwapSpeculation *spec = &gw->speculations[gw->speculationCount++];
+            spec->move = (Move) { gw->selectedRow, gw->selectedCol, gw->selectedRow + dr[i], gw->selectedCol + dc[i] };
+            spec->resolved = false;
         }
     }
 
-    for ( int c = col + 1; c < GRID_WIDTH; c++ ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            right++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
-        }
-    }
+    // the first one is resolved in the press frame, the rest in the next
+    // frames of the drag
+    advanceSpeculations( gw );
 
-    for ( int r = row - 1; r >= 0; r-- ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            top++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
+}
+
+// resolves one pending speculation per frame, the swap being dragged first
+static void advanceSpeculations( GameWorld *gw ) {
+
+    SwapSpeculation *next = NULL;
+
+    for ( int i = 0; i < gw->speculationCount; i++ ) {
+        SwapSpeculation *spec = &gw->speculations[i];
+        if ( !spec->resolved ) {
+            if ( cellAt( gw, spec->move.r2, spec->move.c2 ) == gw->beingSwapped ) {
+                next = spec;
+                break;
+            } else if ( next == NULL ) {
+                next = spec;
+            }
         }
     }
 
-    for ( int r = row + 1; r < GRID_HEIGHT; r++ ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            down++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
-        }
+    if ( next != NULL ) {
+        resolveSpeculation( gw, next );
     }
 
-    //TraceLog( LOG_INFO, "left: %d, right: %d, top: %d, down: %d", left, right, top, down );
+}
 
-    if ( top >= 1 && left == 1 && right == 1 && down == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+static void resolveSpeculation( GameWorld *gw, SwapSpeculation *spec ) {
+
+    if ( spec->resolved ) {
+        return;
     }
 
-    if ( down >= 1 && left == 1 && right == 1 && top == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+    Move move = spec->move;
+    Board *board = gw->board;
+
+    uint8_t t1 = getPieceBoard( board, move.r1, move.c1 );
+    uint8_t t2 = getPieceBoard( board, move.r2, move.c2 );
+
+    spec->resolved = true;
+    spec->valid = false;
+    spec->matchList->groupCount = 0;
+    spec->matchList->cellCount = 0;
+
+    // 1) the jewel types must be different (and not an empty puzzle cell)
+    if ( t1 == t2 || t1 == PIECE_NULL || t2 == PIECE_NULL ) {
+        return;
     }
 
-    if ( left >= 1 && top == 1 && down == 1 && right == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+    /*
+     * 2) the board is stable, so only the lines through the two swapped
+     *    cells can hold a run of three or more pieces; the swapped board
+     *    is then scanned for its groups. Cross, T and L shapes are unions
+     *    of runs that share a cell, so they are found too.
+     */
+    if ( !isMatchingSwapBoard( board, move ) ) {
+        return;
     }
 
-    if ( right >= 1 && top == 1 && down == 1 && left == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+    spec->valid = true;
+
+    // boards larger than the hint search reaches are not copied: the swap
+    // is scanned on the grid itself and undone
+    if ( !fitsBitBoard( gw ) ) {
+        setPieceBoard( board, move.r1, move.c1, t2 );
+        setPieceBoard( board, move.r2, move.c2, t1 );
+        findMatchGroupsTiled( tiledPool( gw ), board, spec->matchList );
+        setPieceBoard( board, move.r1, move.c1, t1 );
+        setPieceBoard( board, move.r2, move.c2, t2 );
+        return;
     }
 
-    positionListUncheckAndClear( gw );
-    return false;
+    board = spec->settled;
+    copyBoard( board, gw->board );
+    setPieceBoard( board, move.r1, move.c1, t2 );
+    setPieceBoard( board, move.r2, move.c2, t1 );
+    findMatchGroupsTiled( tiledPool( gw ), board, spec->matchList );
+
+    // 3) the board the whole cascade (and the reshuffle that may follow
+    //    it) ends on, where the hint search starts once the swap is made,
+    //    resolved with a copy of the game rng, which draws the same
+    //    refills the animations will
+    if ( gw->puzzleIndex < 0 ) {
+        Rng rng = gw->rng;
+        Cascade cascade;
+        resolveTiledBoard( tiledPool( gw ), gw->frameArena, board, &rng, &cascade );
+        ensureMovesBoard( board, &rng );
+    }
 
 }
 
-static bool checkL( GameWorld *gw, int row, int col ) {
+// the grid already holds the swapped pieces
+static void commitSpeculation( GameWorld *gw, SwapSpeculation *spec ) {
 
-    Piece (*grid)[GRID_HEIGHT] = gw->grid;
-    int type = grid[row][col].type;
+    // the lists are swapped, not copied: the speculations are dropped
+    // once the swap is made
+    MatchList *matchList = gw->matchList;
+    gw->matchList = spec->matchList;
+    spec->matchList = matchList;
 
-    int left = 0;
-    int right = 0;
-    int top = 0;
-    int down = 0;
-
-    for ( int c = col - 1; c >= 0; c-- ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            left++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
-        }
+    for ( int i = 0; i < gw->matchList->cellCount; i++ ) {
+        gw->pieceFlags[cellAt( gw, gw->matchList->cells[i].row, gw->matchList->cells[i].col )] |= PIECE_FLAG_CHECKED;
     }
 
-    for ( int c = col + 1; c < GRID_WIDTH; c++ ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            right++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
-        }
-    }
+    markChanged( gw, spec->move.r1, spec->move.c1 );
+    markChanged( gw, spec->move.r2, spec->move.c2 );
+    // boards the hint search does not reach have no settled board: the
+    // search is only stopped
+    startHintSearch( gw, fitsBitBoard( gw ) ? spec->settled : gw->board );
+    processMatches( gw );
 
-    for ( int r = row - 1; r >= 0; r-- ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            top++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
-        }
-    }
+}
 
-    for ( int r = row + 1; r < GRID_HEIGHT; r++ ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            down++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
-        }
-    }
+static int cellAt( GameWorld *gw, int row, int col ) {
+    return row * gw->width + col;
+}
 
-    //TraceLog( LOG_INFO, "left: %d, right: %d, top: %d, down: %d", left, right, top, down );
+// where the piece of a cell is drawn: its cell moved by its offset (for
+// falling pieces, between the last two steps)
+static Vector2 piecePosition( GameWorld *gw, int cell ) {
 
-    if ( top >= 2 && right >= 2 && left == 0 && down == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
-    }
+    float y = gw->pieceOffsets[cell].y;
 
-    if ( top >= 2 && left >= 2 && right == 0 && down == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+    if ( gw->pieceFlags[cell] & PIECE_FLAG_FALLING ) {
+        y = gw->lastFallOffsets[cell] + ( y - gw->lastFallOffsets[cell] ) * gw->stepAlpha;
     }
 
-    if ( down >= 2 && right >= 2 && left == 0 && top == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
-    }
+    return (Vector2) {
+        ( cell % gw->width ) * gw->pieceSize + gw->pieceOffsets[cell].x,
+        ( cell / gw->width ) * gw->pieceSize + y
+    };
 
-    if ( down >= 2 && left >= 2 && right == 0 && top == 0 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
-    }
-
-    positionListUncheckAndClear( gw );
-    return false;
+}
 
+static void drawCell( GameWorld *gw, int cell, int padding ) {
+    drawPiece( gw->board->cells[cell], piecePosition( gw, cell ), gw->pieceSize, gw->pieceFlags[cell], padding );
 }
 
-static bool checkLinear( GameWorld *gw, int row, int col ) {
+static void clearSelection( GameWorld *gw ) {
+    gw->selectedCell = -1;
+    gw->leftNeighbor = -1;
+    gw->rightNeighbor = -1;
+    gw->topNeighbor = -1;
+    gw->downNeighbor = -1;
+    gw->beingSwapped = -1;
+    gw->speculationCount = 0;
+}
 
-    Piece (*grid)[GRID_HEIGHT] = gw->grid;
+static bool fitsBitBoard( GameWorld *gw ) {
+    return gw->width <= BITBOARD_SIZE && gw->height <= BITBOARD_SIZE;
+}
 
-    // horizontal
-    int count = 1;
+// puzzles (and small games) are not worth spreading over the pool
+static ThreadPool *tiledPool( GameWorld *gw ) {
+    return gw->width * gw->height >= GAME_TILED_CELLS ? gw->pool : NULL;
+}
 
-    for ( int c = col + 1; c < GRID_WIDTH; c++ ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            count++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
-        }
+// the changed cells drive the incremental move set of small boards
+static void markChanged( GameWorld *gw, int row, int col ) {
+    if ( fitsBitBoard( gw ) ) {
+        gw->changedCells |= cellBitBoard( row, col );
     }
+}
 
-    for ( int c = col - 1; c >= 0; c-- ) {
-        if ( grid[row][c].type == grid[row][col].type ) {
-            count++;
-            grid[row][c].checked = true;
-            positionListAdd( row, c );
-        } else {
-            break;
+static bool checkMatches( GameWorld *gw ) {
+
+    // most checks find nothing, so the bitboard answers them first
+    if ( fitsBitBoard( gw ) ) {
+        BitBoard bb;
+        loadBitBoard( &bb, gw->board );
+        if ( findAllMatchesBitBoard( &bb ) == 0 ) {
+            gw->matchList->groupCount = 0;
+            gw->matchList->cellCount = 0;
+            return false;
         }
     }
 
-    //TraceLog( LOG_INFO, "horizontal count: %d", count );
+    if ( findMatchGroupsTiled( tiledPool( gw ), gw->board, gw->matchList ) == 0 ) {
+        return false;
+    }
 
-    if ( count >= 3 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+    for ( int i = 0; i < gw->matchList->cellCount; i++ ) {
+        gw->pieceFlags[cellAt( gw, gw->matchList->cells[i].row, gw->matchList->cells[i].col )] |= PIECE_FLAG_CHECKED;
     }
-    positionListUncheckAndClear( gw );
 
-    // vertical
-    count = 1;
+    return true;
 
-    for ( int r = row + 1; r < GRID_HEIGHT; r++ ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            count++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
-        }
+}
+
+static void processMatches( GameWorld *gw ) {
+
+    Board *board = gw->board;
+    Vector2 *offsets = gw->pieceOffsets;
+
+    // 1) remove the pieces of every match group;
+    for ( int k = 0; k < gw->matchList->cellCount; k++ ) {
+        setPieceBoard( board, gw->matchList->cells[k].row, gw->matchList->cells[k].col, PIECE_NULL );
     }
 
-    for ( int r = row - 1; r >= 0; r-- ) {
-        if ( grid[r][col].type == grid[row][col].type ) {
-            count++;
-            grid[r][col].checked = true;
-            positionListAdd( r, col );
-        } else {
-            break;
+    // 2) fall the pieces, compacting each column in a single pass; a
+    //    piece that fell keeps the render state it had in its old cell
+    //    and is drawn from there;
+    Gravity *gravity = gw->gravity;
+    applyGravityTiledBoard( tiledPool( gw ), board, gravity );
+    int *newPieces = gravity->newPieces;
+
+    for ( int j = 0; j < gw->width; j++ ) {
+        for ( int i = gw->height - 1; i >= newPieces[j]; i-- ) {
+            int cell = cellAt( gw, i, j );
+            int fall = gravity->fall[cell];
+            if ( fall > 0 ) {
+                int from = cell - fall * gw->width;
+                offsets[cell] = (Vector2) { offsets[from].x, offsets[from].y - fall * gw->pieceSize };
+                gw->pieceFlags[cell] = gw->pieceFlags[from];
+                animationListAdd( gw, cell );
+                markChanged( gw, i, j );
+            }
         }
     }
 
-    //TraceLog( LOG_INFO, "vertical count: %d", count );
+    // 3) generating new pieces, a whole column at a time, drawn in chunks
+    //    that take the same random numbers (puzzles leave the top cells
+    //    empty instead), starting above the board;
+    uint8_t column[REFILL_CHUNK] = { 0 };
 
-    if ( count >= 3 ) {
-        grid[row][col].checked = true;
-        positionListAdd( row, col );
-        return true;
+    for ( int j = 0; j < gw->width; j++ ) {
+        for ( int first = 0; first < newPieces[j]; first += REFILL_CHUNK ) {
+            int count = newPieces[j] - first < REFILL_CHUNK ? newPieces[j] - first : REFILL_CHUNK;
+            if ( gw->puzzleIndex < 0 ) {
+                fillPiecesRng( &gw->rng, column, count );
+            }
+            for ( int c = 0; c < count; c++ ) {
+                int cell = cellAt( gw, first + c, j );
+                board->cells[cell] = column[c];
+                offsets[cell] = (Vector2) { 0, -newPieces[j] * gw->pieceSize };
+                gw->pieceFlags[cell] = 0;
+                animationListAdd( gw, cell );
+                markChanged( gw, first + c, j );
+            }
+        }
     }
-    positionListUncheckAndClear( gw );
 
-    return false;
+    gw->state = GAME_STATE_DROPPING_NEW_PIECES;
+    gw->fallSpeed = BASE_FALL_SPEED;
 
 }
 
-static bool checkValidityAndCommitChanges( GameWorld *gw, int r1, int c1, int r2, int c2 ) {
+// (re)allocates everything sized by the board when its size changes; the
+// pieces are left for buildGrid to fill
+static void resizeGrid( GameWorld *gw, int width, int height ) {
 
-    Piece (*grid)[GRID_HEIGHT] = gw->grid;
+    // the old pieces are gone, and so is any drag on them (buildGrid puts
+    // the offsets and flags back at rest)
+    clearSelection( gw );
 
-    // 1) check if the jewel type are different
-    if ( grid[r1][c1].type == grid[r2][c2].type ) {
-        return false;
+    if ( gw->board != NULL && gw->width == width && gw->height == height ) {
+        return;
     }
 
-    /*
-     * 2) trigger the same algorithms for selected and moved pieces, marking
-     *    them for removal.
-     * 3) verify each case (more specific to more generic):
-     *    a) cross, 5 pices;
-     *    b) T, 4 or more pieces;
-     *    c) L, 5 or more pieces;
-     *    d) horizontal or vertical, 3 or more pieces.
-     */
-    bool p1Found = checkPiece( gw, r1, c1 );
-    bool p2Found = checkPiece( gw, r2, c2 );
-
-    bool matched = p1Found || p2Found;
-
-    // theres a match
-    if ( matched ) {
-        processMatches( gw );
+    int count = width * height;
+
+    freeGrid( gw );
+
+    gw->width = width;
+    gw->height = height;
+    gw->board = createBoard( width, height );
+    gw->pieceOffsets = (Vector2*) calloc( count, sizeof( Vector2 ) );
+    gw->lastFallOffsets = (float*) calloc( count, sizeof( float ) );
+    gw->pieceFlags = (uint8_t*) calloc( count, sizeof( uint8_t ) );
+    gw->gravity = createGravity( width, height );
+    gw->matchList = createMatchList( count );
+    gw->matchList->scratch = gw->frameArena;
+
+    for ( int i = 0; i < 4; i++ ) {
+        gw->speculations[i].matchList = createMatchList( count );
+        gw->speculations[i].matchList->scratch = gw->frameArena;
+        gw->speculations[i].settled = width <= BITBOARD_SIZE && height <= BITBOARD_SIZE ?
+                                      createBoard( width, height ) : NULL;
     }
 
-    return matched;
+    // pieces fill the window, down to a size that can still be dragged;
+    // larger boards scroll
+    int pieceSize = GetScreenWidth() / width < GetScreenHeight() / height ?
+                    GetScreenWidth() / width : GetScreenHeight() / height;
+    gw->pieceSize = pieceSize < MIN_PIECE_SIZE ? MIN_PIECE_SIZE : pieceSize;
+    gw->camera = (Camera2D) { .zoom = 1 };
 
 }
 
-static bool checkPiece( GameWorld *gw, int row, int col ) {
+static void freeGrid( GameWorld *gw ) {
 
-    bool crossFound = checkCross( gw, row, col );
-    positionListClear();
-    bool tFound = checkT( gw, row, col );
-    positionListClear();
-    bool lFound = checkL( gw, row, col );
-    positionListClear();
-    bool linearFound = checkLinear( gw, row, col );
-    positionListClear();
+    destroyBoard( gw->board );
+    free( gw->pieceOffsets );
+    free( gw->lastFallOffsets );
+    free( gw->pieceFlags );
+    destroyGravity( gw->gravity );
+    destroyMatchList( gw->matchList );
 
-    return crossFound || tFound || lFound || linearFound;
+    for ( int i = 0; i < 4; i++ ) {
+        destroyMatchList( gw->speculations[i].matchList );
+        destroyBoard( gw->speculations[i].settled );
+    }
 
 }
 
-static void processMatches( GameWorld *gw ) {
+static void buildGrid( GameWorld *gw, const Board *puzzle ) {
 
-    // 1) remove pieces;
-    for ( int i = 0; i < GRID_HEIGHT; i++ ) {
-        for ( int j = 0; j < GRID_WIDTH; j++ ) {
-            if ( gw->grid[i][j].checked ) {
-                gw->grid[i][j] = (Piece) {
-                    .type = PIECE_NULL,
-                    .pos = { j * gw->pieceSize, i * gw->pieceSize },
-                    .dim = { gw->pieceSize, gw->pieceSize },
-                    .selected = false,
-                    .checked = false
-                };
-            }
-        }
+    Board *board = gw->board;
+
+    if ( puzzle == NULL ) {
+        initBoard( board, gw->width, gw->height, board->cells );
+        generateBoard( board, &gw->rng );
+    } else if ( puzzle != board ) {
+        copyBoard( board, puzzle );
     }
 
-    // 2) fall the pieces;
+    // every piece rests at its cell
+    memset( gw->pieceOffsets, 0, gw->width * gw->height * sizeof( Vector2 ) );
+    memset( gw->pieceFlags, 0, gw->width * gw->height * sizeof( uint8_t ) );
 
-    // animation
-    for ( int i = 0; i < GRID_HEIGHT; i++ ) {
-        for ( int j = 0; j < GRID_WIDTH; j++ ) {
-            int emptyCount = 0;
-            if ( gw->grid[i][j].type != PIECE_NULL ) {
-                for ( int k = i+1; k < GRID_HEIGHT; k++ ) {
-                    if ( gw->grid[k][j].type == PIECE_NULL ) {
-                        emptyCount++;
-                    }
-                }
-                if ( emptyCount > 0 ) {
-                    animationListAdd( &gw->grid[i+emptyCount][j], gw->grid[i+emptyCount][j].pos.y );
-                    piecesToCheckPositionListAdd( i+emptyCount, j );
-                }
-            }
-        }
-    }
+}
 
-    // "physical" exchange (grid)
-    int newPieces[GRID_WIDTH] = {0};
+static void refreshMoveSet( GameWorld *gw, uint64_t changed ) {
 
-    for ( int i = 0; i < GRID_HEIGHT; i++ ) {
-        for ( int j = 0; j < GRID_WIDTH; j++ ) {
-            if ( gw->grid[i][j].type == PIECE_NULL ) {
-                newPieces[j]++;
-                for ( int k = i; k > 0; k-- ) {
-                    Piece p = gw->grid[k][j];
-                    gw->grid[k][j] = gw->grid[k-1][j];
-                    gw->grid[k-1][j] = p;
-                }
-            }
-        }
+    // boards larger than a bitboard are only scanned up to their first move
+    if ( !fitsBitBoard( gw ) ) {
+        gw->hasMoves = findMovesBoard( gw->board, &gw->firstMove, 1 ) == 1;
+        return;
     }
 
-    // 3) generating new pieces;
-    for ( int j = 0; j < GRID_WIDTH; j++ ) {
-        //TraceLog( LOG_INFO, "%d", newPieces[j] );
-        for ( int k = 0; k < newPieces[j]; k++ ) {
-            gw->grid[k][j] = (Piece) {
-                .type = GetRandomValue( 1, 7 ),
-                .pos = { j * gw->pieceSize, ( k - newPieces[j] ) * gw->pieceSize },
-                .dim = { gw->pieceSize, gw->pieceSize },
-                .selected = false,
-                .checked = false
-            };
-            animationListAdd( &gw->grid[k][j], k * gw->pieceSize );
-            piecesToCheckPositionListAdd( k, j );
-        }
+    BitBoard bb;
+    loadBitBoard( &bb, gw->board );
+
+    // only the swaps around the cells touched by the last cascade change
+    if ( changed == ~0ULL ) {
+        findMovesBitBoard( &bb, &gw->moveSet );
+    } else {
+        updateMovesBitBoard( &bb, &gw->moveSet, changed );
     }
 
-    gw->state = GAME_STATE_DROPPING_NEW_PIECES;
-    fallSpeed = BASE_FALL_SPEED;
+    gw->hasMoves = listMovesBitBoard( &gw->moveSet, &gw->firstMove, 1 ) == 1;
 
 }
 
-static void buildGrid( GameWorld *gw, int *pieces ) {
-
-    for ( int i = 0; i < GRID_HEIGHT; i++ ) {
-        for ( int j = 0; j < GRID_WIDTH; j++ ) {
-            gw->grid[i][j] = (Piece) {
-                .type = pieces == NULL ? GetRandomValue( 1, 7 ) : pieces[i*GRID_WIDTH+j],
-                .pos = { j * gw->pieceSize, i * gw->pieceSize },
-                .dim = { gw->pieceSize, gw->pieceSize },
-                .selected = false,
-                .checked = false
-            };
-        }
-    }
+// arrow keys scroll boards larger than the window
+static void updateCamera( GameWorld *gw, float delta ) {
 
-}
+    float step = CAMERA_PIECES_PER_SECOND * gw->pieceSize * delta;
+    float maxX = fmax( 0, gw->width * gw->pieceSize - GetScreenWidth() );
+    float maxY = fmax( 0, gw->height * gw->pieceSize - GetScreenHeight() );
 
-static void positionListAdd( int row, int col ) {
-    if ( positionListSize < LIST_CAPACITY ) {
-        positionList[positionListSize++] = (Position) { row, col };
+    if ( IsKeyDown( KEY_LEFT ) ) {
+        gw->camera.target.x -= step;
+    }
+    if ( IsKeyDown( KEY_RIGHT ) ) {
+        gw->camera.target.x += step;
+    }
+    if ( IsKeyDown( KEY_UP ) ) {
+        gw->camera.target.y -= step;
+    }
+    if ( IsKeyDown( KEY_DOWN ) ) {
+        gw->camera.target.y += step;
     }
+
+    gw->camera.target.x = fmin( fmax( gw->camera.target.x, 0 ), maxX );
+    gw->camera.target.y = fmin( fmax( gw->camera.target.y, 0 ), maxY );
+
 }
 
-static void positionListClear( void ) {
-    positionListSize = 0;
+static void drawMoveOutline( GameWorld *gw, Move move, Color color ) {
+    DrawRectangleLinesEx( 
+        (Rectangle) {
+            fmin( move.c1, move.c2 ) * gw->pieceSize,
+            fmin( move.r1, move.r2 ) * gw->pieceSize,
+            ( abs( move.c2 - move.c1 ) + 1 ) * gw->pieceSize,
+            ( abs( move.r2 - move.r1 ) + 1 ) * gw->pieceSize
+        },
+        3,
+        color
+    );
 }
 
-static void positionListUncheckAndClear( GameWorld *gw ) {
+static void startHintSearch( GameWorld *gw, const Board *board ) {
 
-    if ( positionListSize > 0 ) {
-        for ( int i = 0; i < positionListSize; i++ ) {
-            gw->grid[positionList[i].row][positionList[i].col].checked = false;
-        }
+    if ( gw->puzzleIndex >= 0 ) {
+        return;
     }
 
-    positionListClear();
+    // the search draws its own refills, the game rng is left untouched so
+    // the replay stays in sync
+    gw->hintSearch.search.config.seed = gw->seed ^ gw->frame;
+    startAnytimeSearch( &gw->hintSearch, board );
 
 }
 
-static void animationListAdd( Piece *p, float targetY ) {
-    if ( animationListSize < LIST_CAPACITY ) {
-        animationList[animationListSize++] = (FallingPiece) { p, targetY };
+/*
+ * Starts solving the puzzle from the current board, when it loads and when
+ * a swap leaves the known solution; the first swap of the shortest
+ * solution is the best hint. The solve is stepped every frame, and the
+ * table, only allocated for the first puzzle, is never cleared: what it
+ * proved still holds for the next boards and puzzles.
+ */
+static void startPuzzleHint( GameWorld *gw ) {
+
+    if ( gw->puzzleTable == NULL ) {
+        gw->puzzleTable = createTranspositionTable( PUZZLE_TABLE_BITS, PUZZLE_SIZE );
     }
+
+    startAnytimePuzzle( &gw->puzzleSolve, gw->board, gw->puzzleGoal, PUZZLE_HINT_DEPTH, gw->puzzleTable );
+
 }
 
-static void animationListClear( void ) {
-    animationListSize = 0;
+// a swap of the solution leaves the rest of it as the solution of the new
+// board; any other swap drops it (and stops a solve still running), to be
+// solved again once the board settles
+static void followPuzzleSolution( GameWorld *gw, Move move ) {
+
+    PuzzleSolution *solution = &gw->puzzleSolve.solution;
+    Move next = solution->moves[0];
+    bool same = ( move.r1 == next.r1 && move.c1 == next.c1 && move.r2 == next.r2 && move.c2 == next.c2 ) ||
+                ( move.r1 == next.r2 && move.c1 == next.c2 && move.r2 == next.r1 && move.c2 == next.c1 );
+
+    if ( solution->solved && solution->moveCount > 0 && same ) {
+        solution->moveCount--;
+        memmove( solution->moves, solution->moves + 1, solution->moveCount * sizeof( Move ) );
+    } else {
+        solution->solved = false;
+        gw->puzzleSolve.finished = true;
+        gw->showBestHint = false;
+    }
+
 }
 
-static void piecesToCheckPositionListAdd( int row, int col ) {
-    if ( piecesToCheckPositionListSize < LIST_CAPACITY ) {
-        piecesToCheckPositionList[piecesToCheckPositionListSize++] = (Position) { row, col };
+static void reshuffleGrid( GameWorld *gw ) {
+
+    // same rule (and same random numbers) as the replay player; the
+    // pieces are drawn straight from the board, so nothing else changes
+    if ( ensureMovesBoard( gw->board, &gw->rng ) ) {
+        refreshMoveSet( gw, ~0ULL );
     }
+
+}
+
+// grows as needed: a cascade on a large board moves many pieces at once;
+// a piece starts its fall at rest, with no step behind it
+static void animationListAdd( GameWorld *gw, int cell ) {
+    *(int*) pushArenaList( &gw->animationList ) = cell;
+    gw->lastFallOffsets[cell] = gw->pieceOffsets[cell].y;
+    gw->pieceFlags[cell] |= PIECE_FLAG_FALLING;
 }
 
-static void piecesToCheckPositionListClear( void ) {
-    piecesToCheckPositionListSize = 0;
+// the list lives in its own arena, taken back whole when a fall ends
+static void animationListClear( GameWorld *gw ) {
+    clearArenaList( &gw->animationList );
+    resetArena( gw->animationArena );
 }
\ No newline at end of file
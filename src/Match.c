@@ -0,0 +1,446 @@
+/**
+ * @file Match.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Match implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "Match.h"
+#include "BitBoard.h"
+#include "RunMask.h"
+
+// boards up to this many cells keep the scratch arrays of findMatchGroups
+// on the stack, larger ones allocate them
+#define MATCH_STACK_CELLS 64
+
+// rows per job of the row pass and columns per job of the column pass
+#define MATCH_BAND_ROWS 16
+#define MATCH_BAND_COLS 32
+
+typedef struct Run {
+    int row;
+    int col;
+    int length;
+    int shared;
+    bool horizontal;
+} Run;
+
+// how two runs of the same group meet, ordered from the weakest shape
+typedef enum Junction {
+    JUNCTION_NONE,
+    JUNCTION_L,
+    JUNCTION_T,
+    JUNCTION_CROSS
+} Junction;
+
+/*
+ * The scratch of one findMatchGroupsTiled call, shared by its band jobs.
+ * Every row has width / 3 run slots and every column height / 3 (the most
+ * runs a line can hold), so the jobs write disjoint slots and the slots a
+ * run gets never depend on how the board was split into bands. mask is
+ * the run mask of the board: only the cells it marks are looked at.
+ */
+typedef struct MatchScan {
+    const Board *board;
+    const uint8_t *mask;
+    Run *runs;
+    int *parent;
+    int *junction;
+    int *cellRun;
+    int *rowRuns;
+    int *colRuns;
+    int rowSlots;
+    int colSlots;
+    int firstColSlot;
+    int rowJobs;
+} MatchScan;
+
+static int findRoot( int *parent, int run ) {
+    while ( parent[run] != run ) {
+        parent[run] = parent[parent[run]];
+        run = parent[run];
+    }
+    return run;
+}
+
+static bool isRunEnd( const Run *run, int row, int col ) {
+    int offset = run->horizontal ? col - run->col : row - run->row;
+    return offset == 0 || offset == run->length - 1;
+}
+
+/**
+ * @brief Initializes an empty match list over groups and cells, with
+ * room for the groups of a board of capacity cells.
+ */
+void initMatchList( MatchList *list, int capacity, MatchGroup *groups, Position *cells ) {
+    list->groups = groups;
+    list->groupCount = 0;
+    list->cells = cells;
+    list->cellCount = 0;
+    list->capacity = capacity;
+    list->scratch = NULL;
+}
+
+/**
+ * @brief Creates a dinamically allocated empty match list, with room for
+ * the groups of a board of capacity cells.
+ */
+MatchList* createMatchList( int capacity ) {
+    MatchList *list = (MatchList*) malloc( sizeof( MatchList ) );
+    initMatchList( list, capacity,
+                   (MatchGroup*) malloc( MATCH_GROUP_CAPACITY( capacity ) * sizeof( MatchGroup ) ),
+                   (Position*) malloc( capacity * sizeof( Position ) ) );
+    return list;
+}
+
+/**
+ * @brief Destroys a match list created with createMatchList.
+ */
+void destroyMatchList( MatchList *list ) {
+    if ( list != NULL ) {
+        free( list->groups );
+        free( list->cells );
+        free( list );
+    }
+}
+
+// the run mask of the board: from its bitboard when it fits one, with
+// the (SIMD) run mask kernels otherwise; returns how many cells it marks
+static int findMask( const Board *board, uint8_t *mask ) {
+
+    if ( board->width > BITBOARD_SIZE || board->height > BITBOARD_SIZE ) {
+        return findRunMask( board->cells, board->width, board->height, mask );
+    }
+
+    BitBoard bb;
+    loadBitBoard( &bb, board );
+    uint64_t matches = findAllMatchesBitBoard( &bb );
+
+    if ( matches == 0 ) {
+        return 0;
+    }
+
+    for ( int i = 0; i < board->height; i++ ) {
+        for ( int j = 0; j < board->width; j++ ) {
+            *mask++ = matches >> ( i * BITBOARD_SIZE + j ) & 1;
+        }
+    }
+
+    return __builtin_popcountll( matches );
+
+}
+
+// row pass of a band of rows: the horizontal runs of each row and the
+// horizontal run of each marked cell, -1 when there is none. A run starts
+// at the first marked cell of a row (a marked cell inside a shorter line
+// of its type belongs to a vertical run only)
+static void scanRows( MatchScan *scan, int band ) {
+
+    int width = scan->board->width;
+    int last = ( band + 1 ) * MATCH_BAND_ROWS;
+
+    if ( last > scan->board->height ) {
+        last = scan->board->height;
+    }
+
+    for ( int i = band * MATCH_BAND_ROWS; i < last; i++ ) {
+        const uint8_t *row = scan->board->cells + i * width;
+        const uint8_t *mask = scan->mask + i * width;
+        int *cellRun = scan->cellRun + i * width;
+        int first = i * scan->rowSlots;
+        int slot = first;
+        const uint8_t *marked;
+        int start = 0;
+        while ( ( marked = memchr( mask + start, 1, width - start ) ) != NULL ) {
+            start = (int) ( marked - mask );
+            int end = start + 1;
+            while ( end < width && row[end] == row[start] ) {
+                end++;
+            }
+            int run = -1;
+            if ( row[start] != PIECE_NULL && end - start >= 3 ) {
+                scan->runs[slot] = (Run) { i, start, end - start, 0, true };
+                scan->parent[slot] = slot;
+                scan->junction[slot] = JUNCTION_NONE;
+                run = slot++;
+            }
+            for ( int j = start; j < end; j++ ) {
+                cellRun[j] = run;
+            }
+            start = end;
+        }
+        scan->rowRuns[i] = slot - first;
+    }
+
+}
+
+// column pass of a band of columns: the vertical runs of each column,
+// joined with the horizontal ones they cross once every band is done. The
+// band is walked row by row over the mask, so each column still finds its
+// runs from top to bottom
+static void scanColumns( MatchScan *scan, int band ) {
+
+    int width = scan->board->width;
+    int height = scan->board->height;
+    const uint8_t *cells = scan->board->cells;
+    int firstCol = band * MATCH_BAND_COLS;
+    int last = firstCol + MATCH_BAND_COLS;
+
+    if ( last > width ) {
+        last = width;
+    }
+
+    for ( int j = firstCol; j < last; j++ ) {
+        scan->colRuns[j] = 0;
+    }
+
+    for ( int i = 0; i < height; i++ ) {
+        const uint8_t *mask = scan->mask + i * width;
+        const uint8_t *marked;
+        int j = firstCol;
+        while ( ( marked = memchr( mask + j, 1, last - j ) ) != NULL ) {
+            j = (int) ( marked - mask );
+            uint8_t type = cells[i * width + j];
+            if ( i == 0 || cells[( i - 1 ) * width + j] != type ) {
+                int end = i + 1;
+                while ( end < height && cells[end * width + j] == type ) {
+                    end++;
+                }
+                if ( end - i >= 3 ) {
+                    int slot = scan->firstColSlot + j * scan->colSlots + scan->colRuns[j]++;
+                    scan->runs[slot] = (Run) { i, j, end - i, 0, false };
+                    scan->parent[slot] = slot;
+                    scan->junction[slot] = JUNCTION_NONE;
+                }
+            }
+            j++;
+        }
+    }
+
+}
+
+// the row bands come first, then the column bands, all in one batch
+static void scanBand( void *data, int job, int worker ) {
+    MatchScan *scan = (MatchScan*) data;
+    if ( job < scan->rowJobs ) {
+        scanRows( scan, job );
+    } else {
+        scanColumns( scan, job - scan->rowJobs );
+    }
+}
+
+/**
+ * @brief Scans the whole board once, with a row and a column run-length
+ * pass, and stores every match group found in list. The board is not
+ * changed. Groups with crossing runs are classified as cross (both runs
+ * crossed in their interior), T (one run touched by the end of the other)
+ * or L (runs sharing an end); groups of a single run are classified by its
+ * length. The capacity of list must be at least the number of cells of
+ * the board. Returns the number of groups found.
+ */
+int findMatchGroups( const Board *board, MatchList *list ) {
+    return findMatchGroupsTiled( NULL, board, list );
+}
+
+/**
+ * @brief Same as findMatchGroups, with the row pass split into bands of
+ * rows and the column pass into bands of columns that run in parallel on
+ * pool (on the calling thread when pool is NULL). Runs crossing the
+ * borders of the bands are joined afterwards, so the groups, their order
+ * and their cells are exactly the ones findMatchGroups finds.
+ */
+int findMatchGroupsTiled( ThreadPool *pool, const Board *board, MatchList *list ) {
+
+    int width = board->width;
+    int height = board->height;
+    int cellCount = width * height;
+    const uint8_t *cells = board->cells;
+
+    MatchScan scan = {
+        .board = board,
+        .rowSlots = width / 3,
+        .colSlots = height / 3,
+        .firstColSlot = height * ( width / 3 ),
+        .rowJobs = ( height + MATCH_BAND_ROWS - 1 ) / MATCH_BAND_ROWS
+    };
+
+    // a line of n cells has at most n / 3 runs, so there are no more run
+    // slots than two thirds of the cells; the int scratch is four arrays
+    // over the slots, one over the cells and a count per row and column
+    int slotCount = scan.firstColSlot + width * scan.colSlots;
+    uint8_t maskStack[MATCH_STACK_CELLS];
+    Run runsStack[MATCH_STACK_CELLS];
+    int scratchStack[6 * MATCH_STACK_CELLS];
+    uint8_t *mask = maskStack;
+    Run *runs = runsStack;
+    int *scratch = scratchStack;
+    bool allocated = false;
+    ArenaMark mark = { 0 };
+
+    list->groupCount = 0;
+    list->cellCount = 0;
+
+    if ( cellCount > MATCH_STACK_CELLS ) {
+        if ( list->scratch != NULL ) {
+            mark = markArena( list->scratch );
+            mask = (uint8_t*) allocArena( list->scratch, cellCount );
+        } else {
+            mask = (uint8_t*) malloc( cellCount );
+            allocated = true;
+        }
+    }
+
+    // the run mask tells at once if there is any match at all, and the
+    // passes below only look at the cells it marks
+    if ( findMask( board, mask ) == 0 ) {
+        if ( allocated ) {
+            free( mask );
+        } else if ( mask != maskStack ) {
+            rewindArena( list->scratch, mark );
+        }
+        return 0;
+    }
+
+    if ( cellCount > MATCH_STACK_CELLS ) {
+        size_t runsSize = slotCount * sizeof( Run );
+        size_t scratchSize = ( 4 * (size_t) slotCount + cellCount + width + height ) * sizeof( int );
+        if ( allocated ) {
+            runs = (Run*) malloc( runsSize );
+            scratch = (int*) malloc( scratchSize );
+        } else {
+            runs = (Run*) allocArena( list->scratch, runsSize );
+            scratch = (int*) allocArena( list->scratch, scratchSize );
+        }
+    }
+
+    scan.mask = mask;
+    scan.runs = runs;
+    scan.parent = scratch;
+    scan.junction = scratch + slotCount;
+    int *groupOf = scratch + 2 * slotCount;
+    int *order = scratch + 3 * slotCount;
+    scan.cellRun = scratch + 4 * slotCount;
+    scan.rowRuns = scan.cellRun + cellCount;
+    scan.colRuns = scan.rowRuns + height;
+
+    int *parent = scan.parent;
+    int *junction = scan.junction;
+    int *cellRun = scan.cellRun;
+    int runCount = 0;
+
+    runThreadPool( pool, scan.rowJobs + ( width + MATCH_BAND_COLS - 1 ) / MATCH_BAND_COLS, scanBand, &scan );
+
+    // the runs in the order a single row pass and column pass find them
+    for ( int i = 0; i < height; i++ ) {
+        for ( int k = 0; k < scan.rowRuns[i]; k++ ) {
+            order[runCount++] = i * scan.rowSlots + k;
+        }
+    }
+
+    int firstVertical = runCount;
+
+    for ( int j = 0; j < width; j++ ) {
+        for ( int k = 0; k < scan.colRuns[j]; k++ ) {
+            order[runCount++] = scan.firstColSlot + j * scan.colSlots + k;
+        }
+    }
+
+    // joins vertical runs with the horizontal runs they cross
+    for ( int v = firstVertical; v < runCount; v++ ) {
+        int r = order[v];
+        Run *run = &runs[r];
+        for ( int i = run->row; i < run->row + run->length; i++ ) {
+            int crossed = cellRun[i * width + run->col];
+            if ( crossed != -1 ) {
+                int ends = isRunEnd( run, i, run->col ) + isRunEnd( &runs[crossed], i, run->col );
+                int kind = ends == 2 ? JUNCTION_L : ends == 1 ? JUNCTION_T : JUNCTION_CROSS;
+                int a = findRoot( parent, r );
+                int b = findRoot( parent, crossed );
+                if ( junction[b] > kind ) {
+                    kind = junction[b];
+                }
+                if ( junction[a] > kind ) {
+                    kind = junction[a];
+                }
+                parent[b] = a;
+                junction[a] = kind;
+                run->shared++;
+            }
+        }
+    }
+
+    // one group per root, in the order their first run was found
+
+    for ( int k = 0; k < runCount; k++ ) {
+        int r = order[k];
+        if ( findRoot( parent, r ) == r ) {
+            MatchGroup *g = &list->groups[list->groupCount];
+            g->type = cells[runs[r].row * width + runs[r].col];
+            g->shape = MATCH_SHAPE_LINE_3;
+            g->firstCell = 0;
+            g->cellCount = 0;
+            groupOf[r] = list->groupCount++;
+        }
+    }
+
+    for ( int k = 0; k < runCount; k++ ) {
+        int r = order[k];
+        int root = findRoot( parent, r );
+        MatchGroup *g = &list->groups[groupOf[root]];
+        if ( junction[root] != JUNCTION_NONE ) {
+            g->shape = junction[root] == JUNCTION_CROSS ? MATCH_SHAPE_CROSS :
+                       junction[root] == JUNCTION_T ? MATCH_SHAPE_T : MATCH_SHAPE_L;
+        } else if ( runs[r].length >= 5 ) {
+            g->shape = MATCH_SHAPE_LINE_5;
+        } else if ( runs[r].length == 4 ) {
+            g->shape = MATCH_SHAPE_LINE_4;
+        }
+    }
+
+    // cells shared by crossing runs belong to their horizontal run only
+    for ( int k = 0; k < runCount; k++ ) {
+        int r = order[k];
+        list->groups[groupOf[findRoot( parent, r )]].cellCount += runs[r].length - runs[r].shared;
+    }
+
+    int first = 0;
+    for ( int g = 0; g < list->groupCount; g++ ) {
+        list->groups[g].firstCell = first;
+        first += list->groups[g].cellCount;
+        list->groups[g].cellCount = 0;
+    }
+
+    for ( int k = 0; k < runCount; k++ ) {
+        const Run *run = &runs[order[k]];
+        MatchGroup *g = &list->groups[groupOf[findRoot( parent, order[k] )]];
+        Position *dst = &list->cells[g->firstCell];
+        if ( run->horizontal ) {
+            for ( int j = run->col; j < run->col + run->length; j++ ) {
+                dst[g->cellCount++] = (Position) { run->row, j };
+            }
+        } else {
+            for ( int i = run->row; i < run->row + run->length; i++ ) {
+                if ( run->shared == 0 || cellRun[i * width + run->col] == -1 ) {
+                    dst[g->cellCount++] = (Position) { i, run->col };
+                }
+            }
+        }
+    }
+
+    list->cellCount = first;
+
+    if ( allocated ) {
+        free( mask );
+        free( runs );
+        free( scratch );
+    } else if ( mask != maskStack ) {
+        rewindArena( list->scratch, mark );
+    }
+
+    return list->groupCount;
+
+}
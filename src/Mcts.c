@@ -0,0 +1,329 @@
+/**
+ * @file Mcts.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Mcts implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "Mcts.h"
+#include "Rng.h"
+#include "Timer.h"
+
+// index of a move in the root statistics: its MoveSet bit, down moves after
+// the right ones
+static int moveIndex( Move move ) {
+    int bit = move.r1 * BITBOARD_SIZE + move.c1;
+    return move.r1 == move.r2 ? bit : BITBOARD_SIZE * BITBOARD_SIZE + bit;
+}
+
+static bool hasMove( const MoveSet *moves, Move move ) {
+    uint64_t bit = cellBitBoard( move.r1, move.c1 );
+    return ( ( move.r1 == move.r2 ? moves->right : moves->down ) & bit ) != 0;
+}
+
+static void addMove( MoveSet *moves, Move move ) {
+    uint64_t bit = cellBitBoard( move.r1, move.c1 );
+    if ( move.r1 == move.r2 ) {
+        moves->right |= bit;
+    } else {
+        moves->down |= bit;
+    }
+}
+
+// the k-th move of a move set, right moves first
+static Move pickMove( const MoveSet *moves, int k ) {
+
+    int rightCount = __builtin_popcountll( moves->right );
+    bool right = k < rightCount;
+    uint64_t mask = right ? moves->right : moves->down;
+
+    if ( !right ) {
+        k -= rightCount;
+    }
+
+    while ( k-- > 0 ) {
+        mask &= mask - 1;
+    }
+
+    int cell = __builtin_ctzll( mask );
+    int row = cell / BITBOARD_SIZE;
+    int col = cell % BITBOARD_SIZE;
+
+    return right ? (Move) { row, col, row, col + 1 } : (Move) { row, col, row + 1, col };
+
+}
+
+static void findMoves( const Board *board, MoveSet *moves ) {
+    BitBoard bb;
+    loadBitBoard( &bb, board );
+    findMovesBitBoard( &bb, moves );
+}
+
+static int addChild( MctsWorker *worker, int parent, Move move ) {
+
+    if ( worker->nodeCount == worker->nodeCapacity ) {
+        return -1;
+    }
+
+    int index = worker->nodeCount++;
+    MctsNode *node = &worker->nodes[index];
+
+    node->move = move;
+    node->visits = 0;
+    node->totalScore = 0;
+    node->firstChild = -1;
+    node->nextSibling = worker->nodes[parent].firstChild;
+    node->expanded = (MoveSet) { 0, 0 };
+    worker->nodes[parent].firstChild = index;
+    addMove( &worker->nodes[parent].expanded, move );
+
+    return index;
+
+}
+
+// the legal child with the highest UCB1 value
+static int selectChild( const MctsWorker *worker, int parent, const MoveSet *legal, float exploration ) {
+
+    const MctsNode *p = &worker->nodes[parent];
+    float logVisits = logf( (float) p->visits );
+    int best = -1;
+    float bestValue = 0;
+
+    for ( int c = p->firstChild; c != -1; c = worker->nodes[c].nextSibling ) {
+        const MctsNode *child = &worker->nodes[c];
+        if ( !hasMove( legal, child->move ) ) {
+            continue;
+        }
+        float value = child->totalScore / child->visits +
+                      exploration * sqrtf( logVisits / child->visits );
+        if ( best == -1 || value > bestValue ) {
+            best = c;
+            bestValue = value;
+        }
+    }
+
+    return best;
+
+}
+
+// one playout: selection and expansion inside the tree, then random moves
+// until the horizon, then every node on the path gets the cells cleared
+// from its own move onwards
+static void playout( const MctsConfig *config, MctsWorker *worker, const Board *root, Rng *rng ) {
+
+    uint8_t cells[BITBOARD_CELLS];
+    Board board = { .cells = cells };
+    int path[MCTS_MAX_DEPTH + 1];
+    int scoreBefore[MCTS_MAX_DEPTH + 1];
+    int depth = 0;
+    int score = 0;
+    int played = 0;
+    bool inTree = true;
+
+    copyBoard( &board, root );
+    path[0] = 0;
+    scoreBefore[0] = 0;
+
+    while ( played < config->horizon ) {
+
+        MoveSet legal;
+        findMoves( &board, &legal );
+
+        int legalCount = countMovesBitBoard( &legal );
+        if ( legalCount == 0 ) {
+            break;
+        }
+
+        Move move;
+
+        if ( inTree ) {
+
+            MctsNode *node = &worker->nodes[path[depth]];
+            MoveSet untried = { legal.right & ~node->expanded.right, legal.down & ~node->expanded.down };
+            int untriedCount = countMovesBitBoard( &untried );
+            int next;
+
+            if ( untriedCount > 0 || depth == MCTS_MAX_DEPTH ) {
+                move = untriedCount > 0 ? pickMove( &untried, boundedRng( rng, untriedCount ) ) :
+                                          pickMove( &legal, boundedRng( rng, legalCount ) );
+                next = depth < MCTS_MAX_DEPTH ? addChild( worker, path[depth], move ) : -1;
+                inTree = false;
+            } else {
+                next = selectChild( worker, path[depth], &legal, config->exploration );
+                move = worker->nodes[next].move;
+            }
+
+            if ( next != -1 ) {
+                depth++;
+                path[depth] = next;
+                scoreBefore[depth] = score;
+            } else {
+                inTree = false;
+            }
+
+        } else {
+            move = pickMove( &legal, boundedRng( rng, legalCount ) );
+        }
+
+        resolveSwapBoard( &board, move, rng, &worker->cascade );
+        score += worker->cascade.clearedCells;
+        played++;
+
+    }
+
+    for ( int d = 0; d <= depth; d++ ) {
+        MctsNode *node = &worker->nodes[path[d]];
+        node->visits++;
+        node->totalScore += score - scoreBefore[d];
+    }
+
+}
+
+static void growTree( void *data, int tree, int worker ) {
+
+    Mcts *mcts = (Mcts*) data;
+    const MctsConfig *config = &mcts->config;
+    MctsWorker *w = &mcts->workers[worker];
+    int playouts = config->playouts / config->trees + ( tree < config->playouts % config->trees ? 1 : 0 );
+    int *visits = &mcts->rootVisits[tree * MCTS_ROOT_MOVES];
+    float *scores = &mcts->rootScores[tree * MCTS_ROOT_MOVES];
+    Rng rng;
+
+    seedRng( &rng, config->seed, (uint64_t) tree + 1 );
+
+    w->nodeCount = 1;
+    w->nodes[0] = (MctsNode) { { 0, 0, 0, 0 }, 0, 0, -1, -1, { 0, 0 } };
+
+    for ( int i = 0; i < playouts; i++ ) {
+        playout( config, w, mcts->board, &rng );
+    }
+
+    for ( int c = w->nodes[0].firstChild; c != -1; c = w->nodes[c].nextSibling ) {
+        int index = moveIndex( w->nodes[c].move );
+        visits[index] = w->nodes[c].visits;
+        scores[index] = w->nodes[c].totalScore;
+    }
+
+}
+
+/**
+ * @brief Creates a dinamically allocated Mcts able to run on workerCount
+ * threads, with every node pool allocated up front.
+ */
+Mcts* createMcts( MctsConfig config, int workerCount ) {
+
+    Mcts *mcts = (Mcts*) calloc( 1, sizeof( Mcts ) );
+
+    if ( config.trees < 1 ) {
+        config.trees = 1;
+    }
+
+    if ( config.playouts < config.trees ) {
+        config.playouts = config.trees;
+    }
+
+    mcts->config = config;
+    mcts->workerCount = workerCount > 0 ? workerCount : 1;
+    mcts->workers = (MctsWorker*) calloc( mcts->workerCount, sizeof( MctsWorker ) );
+    mcts->rootVisits = (int*) calloc( (size_t) config.trees * MCTS_ROOT_MOVES, sizeof( int ) );
+    mcts->rootScores = (float*) calloc( (size_t) config.trees * MCTS_ROOT_MOVES, sizeof( float ) );
+
+    // a playout adds at most one node
+    for ( int i = 0; i < mcts->workerCount; i++ ) {
+        mcts->workers[i].nodeCapacity = config.playouts / config.trees + 2;
+        mcts->workers[i].nodes = (MctsNode*) malloc( mcts->workers[i].nodeCapacity * sizeof( MctsNode ) );
+    }
+
+    return mcts;
+
+}
+
+/**
+ * @brief Destroys a Mcts and its node pools.
+ */
+void destroyMcts( Mcts *mcts ) {
+
+    for ( int i = 0; i < mcts->workerCount; i++ ) {
+        free( mcts->workers[i].nodes );
+    }
+
+    free( mcts->rootScores );
+    free( mcts->rootVisits );
+    free( mcts->workers );
+    free( mcts );
+
+}
+
+/**
+ * @brief Grows config.trees trees from a stable board (of at most 8 x 8
+ * cells) and stores the most visited root move in result, along with the
+ * playout throughput. Trees are jobs of pool, which must have at most the
+ * workerCount threads given to createMcts; when pool is NULL they are
+ * grown on the calling thread. Tree t always uses random stream t + 1, so
+ * the result only depends on the configuration, not on the scheduling.
+ * Returns false when the board has no legal move or is larger than 8 x 8
+ * cells.
+ */
+bool findBestMoveMcts( Mcts *mcts, ThreadPool *pool, const Board *board, MctsResult *result ) {
+
+    const MctsConfig *config = &mcts->config;
+    size_t statCount = (size_t) config->trees * MCTS_ROOT_MOVES;
+    uint64_t start = getMicrosecondsTimer();
+
+    if ( board->width > BITBOARD_SIZE || board->height > BITBOARD_SIZE ) {
+        *result = (MctsResult) { 0 };
+        return false;
+    }
+
+    memset( mcts->rootVisits, 0, statCount * sizeof( int ) );
+    memset( mcts->rootScores, 0, statCount * sizeof( float ) );
+    mcts->board = board;
+
+    if ( pool != NULL ) {
+        runThreadPool( pool, config->trees, growTree, mcts );
+    } else {
+        for ( int t = 0; t < config->trees; t++ ) {
+            growTree( mcts, t, 0 );
+        }
+    }
+
+    result->found = false;
+    result->visits = 0;
+    result->expectedScore = 0;
+
+    for ( int m = 0; m < MCTS_ROOT_MOVES; m++ ) {
+
+        long long visits = 0;
+        double score = 0;
+
+        for ( int t = 0; t < config->trees; t++ ) {
+            visits += mcts->rootVisits[t * MCTS_ROOT_MOVES + m];
+            score += mcts->rootScores[t * MCTS_ROOT_MOVES + m];
+        }
+
+        if ( visits > result->visits ) {
+            int bit = m % ( BITBOARD_SIZE * BITBOARD_SIZE );
+            int row = bit / BITBOARD_SIZE;
+            int col = bit % BITBOARD_SIZE;
+            result->found = true;
+            result->move = m < BITBOARD_SIZE * BITBOARD_SIZE ? (Move) { row, col, row, col + 1 } :
+                                                                (Move) { row, col, row + 1, col };
+            result->visits = visits;
+            result->expectedScore = (float) ( score / visits );
+        }
+
+    }
+
+    result->playouts = config->playouts;
+    result->seconds = ( getMicrosecondsTimer() - start ) / 1e6;
+    result->playoutsPerSecond = result->seconds > 0 ? result->playouts / result->seconds : 0;
+
+    return result->found;
+
+}
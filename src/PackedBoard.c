@@ -0,0 +1,236 @@
+/**
+ * @file PackedBoard.c
+ * @author Prof. Dr. David Buzatto
+ * @brief PackedBoard implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "PackedBoard.h"
+
+#define PACKED_BOARD_TYPE_BITS 3
+#define PACKED_BOARD_TYPE_MASK 7
+
+// the cells of a width x height board inside the bitboard layout
+static uint64_t boardMask( int width, int height ) {
+
+    uint64_t row = ( 1ULL << width ) - 1;
+    uint64_t mask = 0;
+
+    for ( int i = 0; i < height; i++ ) {
+        mask |= row << ( i * BITBOARD_SIZE );
+    }
+
+    return mask;
+
+}
+
+static uint64_t mix( uint64_t x ) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Packs board, which must fit in BITBOARD_SIZE x BITBOARD_SIZE
+ * cells, into packed.
+ */
+void loadPackedBoard( PackedBoard *packed, const Board *board ) {
+
+    BitBoard bb;
+    loadBitBoard( &bb, board );
+
+    // a plane is the union of the masks of the types with its bit set
+    for ( int k = 0; k < PACKED_BOARD_PLANES; k++ ) {
+        packed->planes[k] = 0;
+        for ( int t = 1; t < PIECE_TYPE_COUNT; t++ ) {
+            if ( t >> k & 1 ) {
+                packed->planes[k] |= bb.pieces[t];
+            }
+        }
+    }
+
+    packed->width = (uint8_t) board->width;
+    packed->height = (uint8_t) board->height;
+
+}
+
+/**
+ * @brief Unpacks packed into board, whose cells must have room for the
+ * packed board.
+ */
+void storePackedBoard( const PackedBoard *packed, Board *board ) {
+
+    uint8_t *cells = board->cells;
+
+    board->width = packed->width;
+    board->height = packed->height;
+
+    for ( int i = 0; i < packed->height; i++ ) {
+        int bit = i * BITBOARD_SIZE;
+        for ( int j = 0; j < packed->width; j++, bit++ ) {
+            *cells++ = (uint8_t) ( ( packed->planes[0] >> bit & 1 ) |
+                                   ( packed->planes[1] >> bit & 1 ) << 1 |
+                                   ( packed->planes[2] >> bit & 1 ) << 2 );
+        }
+    }
+
+}
+
+/**
+ * @brief Fills bb with the piece masks of packed, straight from its
+ * planes.
+ */
+void toBitBoardPackedBoard( const PackedBoard *packed, BitBoard *bb ) {
+
+    uint64_t inside = boardMask( packed->width, packed->height );
+
+    for ( int t = 0; t < PIECE_TYPE_COUNT; t++ ) {
+        uint64_t pieces = inside;
+        for ( int k = 0; k < PACKED_BOARD_PLANES; k++ ) {
+            pieces &= t >> k & 1 ? packed->planes[k] : ~packed->planes[k];
+        }
+        bb->pieces[t] = pieces;
+    }
+
+}
+
+/**
+ * @brief Returns true if both packed boards have the same size and cells.
+ */
+bool equalsPackedBoard( const PackedBoard *a, const PackedBoard *b ) {
+    return a->planes[0] == b->planes[0] && a->planes[1] == b->planes[1] && a->planes[2] == b->planes[2] &&
+           a->width == b->width && a->height == b->height;
+}
+
+/**
+ * @brief Returns a 64-bit hash of the size and cells of packed. Unlike
+ * hashBoardZobrist it can not be updated move by move, but it costs a
+ * few multiplications.
+ */
+uint64_t hashPackedBoard( const PackedBoard *packed ) {
+
+    uint64_t hash = mix( (uint64_t) packed->width << 8 | packed->height );
+
+    for ( int k = 0; k < PACKED_BOARD_PLANES; k++ ) {
+        hash = mix( hash ^ packed->planes[k] );
+    }
+
+    return hash;
+
+}
+
+/**
+ * @brief Copies count packed boards from src to dst (which must not
+ * overlap).
+ */
+void copyPackedBoards( PackedBoard *dst, const PackedBoard *src, int count ) {
+    memcpy( dst, src, count * sizeof( PackedBoard ) );
+}
+
+/**
+ * @brief Returns the index of the first of the count packed boards equal
+ * to key, or -1 if there is none.
+ */
+int findPackedBoard( const PackedBoard *boards, int count, const PackedBoard *key ) {
+
+    for ( int i = 0; i < count; i++ ) {
+        if ( equalsPackedBoard( &boards[i], key ) ) {
+            return i;
+        }
+    }
+
+    return -1;
+
+}
+
+/**
+ * @brief Returns how many bytes encodePackedBoard writes for a board of
+ * width x height cells.
+ */
+size_t getEncodedSizePackedBoard( int width, int height ) {
+    return PACKED_BOARD_HEADER_SIZE + ( (size_t) width * height * PACKED_BOARD_TYPE_BITS + 7 ) / 8;
+}
+
+/**
+ * @brief Encodes board, of any size, in out: the header followed by the
+ * cells in row-major order, three bits each, from the lowest bit of each
+ * byte up. out must have room for getEncodedSizePackedBoard bytes.
+ * Returns how many bytes were written.
+ */
+size_t encodePackedBoard( const Board *board, uint8_t *out ) {
+
+    size_t count = (size_t) board->width * board->height;
+    uint8_t *dst = out + PACKED_BOARD_HEADER_SIZE;
+    uint64_t buffer = 0;
+    int bits = 0;
+
+    out[0] = (uint8_t) board->width;
+    out[1] = (uint8_t) ( board->width >> 8 );
+    out[2] = (uint8_t) board->height;
+    out[3] = (uint8_t) ( board->height >> 8 );
+
+    for ( size_t i = 0; i < count; i++ ) {
+        buffer |= (uint64_t) ( board->cells[i] & PACKED_BOARD_TYPE_MASK ) << bits;
+        bits += PACKED_BOARD_TYPE_BITS;
+        while ( bits >= 8 ) {
+            *dst++ = (uint8_t) buffer;
+            buffer >>= 8;
+            bits -= 8;
+        }
+    }
+
+    if ( bits > 0 ) {
+        *dst++ = (uint8_t) buffer;
+    }
+
+    return (size_t) ( dst - out );
+
+}
+
+/**
+ * @brief Decodes a board encoded by encodePackedBoard from the size bytes
+ * of in. The cells of board must have room for the encoded board. Returns
+ * false, leaving board unchanged, if the bytes are not a valid encoding.
+ */
+bool decodePackedBoard( const uint8_t *in, size_t size, Board *board ) {
+
+    if ( size < PACKED_BOARD_HEADER_SIZE ) {
+        return false;
+    }
+
+    int width = in[0] | in[1] << 8;
+    int height = in[2] | in[3] << 8;
+
+    if ( !isValidSizeBoard( width, height ) || size != getEncodedSizePackedBoard( width, height ) ) {
+        return false;
+    }
+
+    size_t count = (size_t) width * height;
+    const uint8_t *src = in + PACKED_BOARD_HEADER_SIZE;
+    uint64_t buffer = 0;
+    int bits = 0;
+
+    board->width = width;
+    board->height = height;
+
+    for ( size_t i = 0; i < count; i++ ) {
+        while ( bits < PACKED_BOARD_TYPE_BITS ) {
+            buffer |= (uint64_t) *src++ << bits;
+            bits += 8;
+        }
+        board->cells[i] = (uint8_t) ( buffer & PACKED_BOARD_TYPE_MASK );
+        buffer >>= PACKED_BOARD_TYPE_BITS;
+        bits -= PACKED_BOARD_TYPE_BITS;
+    }
+
+    return true;
+
+}
@@ -15,31 +15,36 @@ static Rectangle pieceRect[] = {
     { 666, 255, 205, 205 },
 };
 
-void drawPiece( Piece *p, int padding ) {
+void drawPiece( PieceType type, Vector2 pos, float size, uint8_t flags, int padding ) {
+
+    // cleared cells of a puzzle are never refilled
+    if ( type == PIECE_NULL ) {
+        return;
+    }
     
-    float escaleW = ( p->dim.x - padding * 2 ) / pieceRect[p->type].width;
-    float escaleH = ( p->dim.y - padding * 2 ) / pieceRect[p->type].height;
+    float escaleW = ( size - padding * 2 ) / pieceRect[type].width;
+    float escaleH = ( size - padding * 2 ) / pieceRect[type].height;
 
     DrawTexturePro( 
         rm.pieces, 
-        pieceRect[p->type], 
+        pieceRect[type], 
         (Rectangle) { 
-            p->pos.x + padding,
-            p->pos.y + padding,
-            pieceRect[p->type].width * escaleW, 
-            pieceRect[p->type].height * escaleH
+            pos.x + padding,
+            pos.y + padding,
+            pieceRect[type].width * escaleW, 
+            pieceRect[type].height * escaleH
         },
         (Vector2) { 0, 0 }, 
         0, 
         WHITE
     );
 
-    /*if ( p->selected ) {
-        DrawRectangleLines( p->pos.x, p->pos.y, p->dim.x, p->dim.y, BLACK );
+    /*if ( flags & PIECE_FLAG_SELECTED ) {
+        DrawRectangleLines( pos.x, pos.y, size, size, BLACK );
     }*/
 
-    if ( p->checked ) {
-        DrawCircle( p->pos.x + 10, p->pos.y + 10, 5, WHITE );
+    if ( flags & PIECE_FLAG_CHECKED ) {
+        DrawCircle( pos.x + 10, pos.y + 10, 5, WHITE );
     }
 
 }
\ No newline at end of file
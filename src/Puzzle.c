@@ -0,0 +1,516 @@
+/**
+ * @file Puzzle.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Puzzle implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Puzzle.h"
+#include "BitBoard.h"
+#include "Cascade.h"
+#include "Search.h"
+#include "Timer.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+#define PUZZLE_TABLE_PROVEN 255
+
+// the clock is read once every this many nodes (a power of two)
+#define PUZZLE_CLOCK_NODES 64
+
+// CUTOFF: no solution within the moves left. UNSOLVABLE: no solution at
+// all, every sequence from the board was tried
+typedef enum PuzzleOutcome {
+    PUZZLE_FOUND,
+    PUZZLE_CUTOFF,
+    PUZZLE_UNSOLVABLE,
+    PUZZLE_ABORTED
+} PuzzleOutcome;
+
+typedef struct PuzzleWorker {
+    Cascade cascade;
+    Move moves[PUZZLE_MAX_DEPTH][SEARCH_MOVE_CAPACITY];
+    long long nodes;
+} PuzzleWorker;
+
+typedef struct PuzzleSearch {
+    PuzzleGoal goal;
+    TranspositionTable *table;
+    PuzzleWorker *workers;
+    const Board *root;
+    uint64_t rootHash;
+    Move rootMoves[SEARCH_MOVE_CAPACITY];
+    int rootMoveCount;
+    int depth;
+    int bestRoot;
+    bool cutoff;
+    uint64_t deadline;
+    bool timedOut;
+    Move paths[SEARCH_MOVE_CAPACITY][PUZZLE_MAX_DEPTH];
+} PuzzleSearch;
+
+typedef struct BuiltinPuzzle {
+    const char *name;
+    PuzzleGoal goal;
+    uint8_t pieces[PUZZLE_SIZE * PUZZLE_SIZE];
+} BuiltinPuzzle;
+
+// stable boards, each named after a shape its minimal solution makes and
+// solvable with its goal (tools/puzzle.c checks them)
+static const BuiltinPuzzle builtinPuzzles[PUZZLE_BUILTIN_COUNT] = {
+    {
+        "cross", { PUZZLE_GOAL_EMPTY_BOARD, PIECE_NULL }, {
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 4, 0, 0, 0,
+            0, 0, 0, 4, 3, 0, 0, 0,
+            0, 0, 3, 3, 4, 3, 0, 0,
+            0, 0, 4, 4, 3, 4, 0, 0,
+            0, 0, 4, 4, 3, 4, 0, 0
+        }
+    },
+    {
+        "t", { PUZZLE_GOAL_CLEAR_COLOR, 4 }, {
+            1, 4, 1, 1, 1, 4, 1, 1,
+            1, 4, 1, 1, 4, 3, 4, 1,
+            4, 3, 4, 1, 1, 4, 1, 1,
+            1, 4, 1, 1, 1, 4, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 4, 1, 1, 4, 1, 1,
+            4, 4, 3, 4, 4, 3, 4, 4,
+            1, 1, 4, 1, 1, 4, 1, 1
+        }
+    },
+    {
+        "l", { PUZZLE_GOAL_EMPTY_BOARD, PIECE_NULL }, {
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 4, 4, 0, 0,
+            0, 0, 3, 4, 3, 4, 0, 0,
+            0, 0, 3, 4, 4, 3, 0, 0,
+            0, 0, 4, 3, 3, 4, 0, 0,
+            0, 0, 3, 3, 4, 3, 0, 0
+        }
+    },
+    {
+        "linear", { PUZZLE_GOAL_EMPTY_BOARD, PIECE_NULL }, {
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 3, 3, 4, 0, 0, 0,
+            0, 0, 4, 3, 3, 0, 0, 0,
+            0, 0, 3, 4, 3, 4, 0, 0,
+            0, 0, 4, 3, 4, 4, 0, 0,
+            0, 0, 3, 4, 4, 3, 0, 0
+        }
+    }
+};
+
+// true when some color the goal must clear has one or two pieces left:
+// without refills they can never be part of a run of three
+static bool isHopeless( const BitBoard *bb, PuzzleGoal goal ) {
+
+    for ( int t = 1; t < PIECE_TYPE_COUNT; t++ ) {
+        if ( goal.type == PUZZLE_GOAL_CLEAR_COLOR && t != (int) goal.color ) {
+            continue;
+        }
+        int count = __builtin_popcountll( bb->pieces[t] );
+        if ( count == 1 || count == 2 ) {
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+static bool reachedGoal( const BitBoard *bb, PuzzleGoal goal ) {
+
+    if ( goal.type == PUZZLE_GOAL_CLEAR_COLOR ) {
+        return bb->pieces[goal.color] == 0;
+    }
+
+    for ( int t = 1; t < PIECE_TYPE_COUNT; t++ ) {
+        if ( bb->pieces[t] != 0 ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+static PuzzleOutcome searchPuzzle( PuzzleSearch *search, PuzzleWorker *worker, const Board *board, uint64_t hash,
+                                   int ply, int rootIndex, Move *path ) {
+
+    BitBoard bb;
+    TableProbe probe;
+    int remaining = search->depth - ply;
+
+    worker->nodes++;
+    loadBitBoard( &bb, board );
+
+    if ( reachedGoal( &bb, search->goal ) ) {
+        return PUZZLE_FOUND;
+    }
+
+    if ( isHopeless( &bb, search->goal ) ) {
+        return PUZZLE_UNSOLVABLE;
+    }
+
+    // a lower first move already solved this depth
+    if ( __atomic_load_n( &search->bestRoot, __ATOMIC_RELAXED ) < rootIndex ) {
+        return PUZZLE_ABORTED;
+    }
+
+    // out of time: the whole depth is searched again by the next step
+    if ( search->deadline != 0 && ( worker->nodes & ( PUZZLE_CLOCK_NODES - 1 ) ) == 0 &&
+         getMicrosecondsTimer() >= search->deadline ) {
+        __atomic_store_n( &search->timedOut, true, __ATOMIC_RELAXED );
+    }
+    if ( __atomic_load_n( &search->timedOut, __ATOMIC_RELAXED ) ) {
+        return PUZZLE_ABORTED;
+    }
+
+    if ( probeTranspositionTable( search->table, hash, &probe ) ) {
+        if ( probe.depth == PUZZLE_TABLE_PROVEN ) {
+            return PUZZLE_UNSOLVABLE;
+        }
+        if ( probe.depth >= remaining ) {
+            return PUZZLE_CUTOFF;
+        }
+    }
+
+    if ( remaining == 0 ) {
+        return PUZZLE_CUTOFF;
+    }
+
+    MoveSet moveSet;
+    Move *moves = worker->moves[ply];
+    findMovesBitBoard( &bb, &moveSet );
+    int moveCount = listMovesBitBoard( &moveSet, moves, SEARCH_MOVE_CAPACITY );
+    PuzzleOutcome result = PUZZLE_UNSOLVABLE;
+
+    for ( int i = 0; i < moveCount; i++ ) {
+
+        uint8_t cells[BITBOARD_CELLS];
+        Board child = { .cells = cells };
+
+        copyBoard( &child, board );
+        resolveSwapBoard( &child, moves[i], NULL, &worker->cascade );
+        path[ply] = moves[i];
+
+        PuzzleOutcome outcome = searchPuzzle( search, worker, &child, hash ^ worker->cascade.hashDelta,
+                                              ply + 1, rootIndex, path );
+        if ( outcome == PUZZLE_FOUND ) {
+            return PUZZLE_FOUND;
+        }
+        if ( outcome == PUZZLE_ABORTED ) {
+            result = PUZZLE_ABORTED;
+        } else if ( outcome == PUZZLE_CUTOFF && result == PUZZLE_UNSOLVABLE ) {
+            result = PUZZLE_CUTOFF;
+        }
+
+    }
+
+    // an aborted search proves nothing
+    if ( result == PUZZLE_CUTOFF ) {
+        storeTranspositionTable( search->table, hash, 0, remaining, (Move) { 0, 0, 0, 1 } );
+    } else if ( result == PUZZLE_UNSOLVABLE ) {
+        storeTranspositionTable( search->table, hash, 0, PUZZLE_TABLE_PROVEN, (Move) { 0, 0, 0, 1 } );
+    }
+
+    return result;
+
+}
+
+static void searchRootMove( void *data, int job, int worker ) {
+
+    PuzzleSearch *search = (PuzzleSearch*) data;
+    PuzzleWorker *w = &search->workers[worker];
+    uint8_t cells[BITBOARD_CELLS];
+    Board child = { .cells = cells };
+    Move *path = search->paths[job];
+
+    copyBoard( &child, search->root );
+    resolveSwapBoard( &child, search->rootMoves[job], NULL, &w->cascade );
+    path[0] = search->rootMoves[job];
+
+    PuzzleOutcome outcome = searchPuzzle( search, w, &child, search->rootHash ^ w->cascade.hashDelta, 1, job, path );
+
+    if ( outcome == PUZZLE_CUTOFF ) {
+        __atomic_store_n( &search->cutoff, true, __ATOMIC_RELAXED );
+    } else if ( outcome == PUZZLE_FOUND ) {
+        int best = __atomic_load_n( &search->bestRoot, __ATOMIC_RELAXED );
+        while ( job < best && !__atomic_compare_exchange_n( &search->bestRoot, &best, job, false,
+                                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+        }
+    }
+
+}
+
+// the number of swaps in a solution path: the search stops at the first
+// board that reaches the goal, which may come before the current depth
+static int pathLength( const PuzzleSearch *search, int rootIndex ) {
+
+    uint8_t cells[BITBOARD_CELLS];
+    Board board = { .cells = cells };
+
+    copyBoard( &board, search->root );
+
+    for ( int i = 0; i < search->depth; i++ ) {
+        applyMovePuzzle( &board, search->paths[rootIndex][i] );
+        if ( isSolvedPuzzle( &board, search->goal ) ) {
+            return i + 1;
+        }
+    }
+
+    return search->depth;
+
+}
+
+// the table is shared by every goal: its key tells the goals apart, so
+// what was proven for one goal is never read for another
+static uint64_t hashGoal( PuzzleGoal goal ) {
+    return goal.type == PUZZLE_GOAL_EMPTY_BOARD ? 0 : goal.color * 0x9E3779B97F4A7C15ULL;
+}
+
+static PuzzleSearch *createPuzzleSearch( const Board *board, PuzzleGoal goal, TranspositionTable *table,
+                                         int workerCount, uint64_t deadline ) {
+
+    PuzzleSearch *search = (PuzzleSearch*) malloc( sizeof( PuzzleSearch ) );
+
+    search->goal = goal;
+    search->table = table;
+    search->workers = (PuzzleWorker*) calloc( workerCount, sizeof( PuzzleWorker ) );
+    search->root = board;
+    search->rootHash = hashBoardZobrist( board ) ^ hashGoal( goal );
+    search->rootMoveCount = listMovesSearch( board, search->rootMoves );
+    search->deadline = deadline;
+    search->timedOut = false;
+
+    return search;
+
+}
+
+// adds the nodes of the search to the solution
+static void destroyPuzzleSearch( PuzzleSearch *search, int workerCount, PuzzleSolution *solution ) {
+
+    for ( int i = 0; i < workerCount; i++ ) {
+        solution->nodes += search->workers[i].nodes;
+    }
+
+    free( search->workers );
+    free( search );
+
+}
+
+// the solution of a board before any search: solved if it already
+// reached the goal, unsolvable if it can never reach it
+static void initSolution( const Board *board, PuzzleGoal goal, PuzzleSolution *solution ) {
+
+    BitBoard bb;
+    loadBitBoard( &bb, board );
+
+    solution->solved = reachedGoal( &bb, goal );
+    solution->unsolvable = !solution->solved && isHopeless( &bb, goal );
+    solution->moveCount = 0;
+    solution->nodes = 0;
+    solution->microseconds = 0;
+
+}
+
+// iterative deepening from depth up to maxDepth, until the board is solved
+// or proven unsolvable. Returns the next depth to search: a depth cut short
+// by the deadline is dropped and searched again, the table keeping the
+// branches it already proved
+static int deepenPuzzle( PuzzleSearch *search, ThreadPool *pool, int depth, int maxDepth,
+                         PuzzleSolution *solution ) {
+
+    for ( ; depth <= maxDepth && !solution->solved && !solution->unsolvable; depth++ ) {
+
+        search->depth = depth;
+        search->bestRoot = search->rootMoveCount;
+        search->cutoff = false;
+
+        if ( pool != NULL ) {
+            runThreadPool( pool, search->rootMoveCount, searchRootMove, search );
+        } else {
+            for ( int i = 0; i < search->rootMoveCount; i++ ) {
+                searchRootMove( search, i, 0 );
+            }
+        }
+
+        if ( search->timedOut ) {
+            break;
+        }
+
+        if ( search->bestRoot < search->rootMoveCount ) {
+            solution->solved = true;
+            solution->moveCount = pathLength( search, search->bestRoot );
+            memcpy( solution->moves, search->paths[search->bestRoot], solution->moveCount * sizeof( Move ) );
+        } else if ( !search->cutoff ) {
+            // every first move was proven to lead nowhere
+            solution->unsolvable = true;
+        }
+
+    }
+
+    return depth;
+
+}
+
+/**
+ * @brief Loads one of the built-in puzzles (0 up to PUZZLE_BUILTIN_COUNT -
+ * 1), already stable, with its goal. Every built-in puzzle has
+ * PUZZLE_SIZE x PUZZLE_SIZE cells, which the cells of board must have room
+ * for. Returns its name, or NULL if there is no such puzzle.
+ */
+const char *loadBuiltinPuzzle( int index, Board *board, PuzzleGoal *goal ) {
+
+    if ( index < 0 || index >= PUZZLE_BUILTIN_COUNT ) {
+        return NULL;
+    }
+
+    const BuiltinPuzzle *puzzle = &builtinPuzzles[index];
+
+    initBoard( board, PUZZLE_SIZE, PUZZLE_SIZE, board->cells );
+    memcpy( board->cells, puzzle->pieces, PUZZLE_SIZE * PUZZLE_SIZE );
+    stabilizePuzzle( board );
+    *goal = puzzle->goal;
+
+    return puzzle->name;
+
+}
+
+/**
+ * @brief Removes the matches a puzzle starts with, without refilling.
+ */
+void stabilizePuzzle( Board *board ) {
+    Cascade cascade;
+    resolveBoard( board, NULL, &cascade );
+}
+
+/**
+ * @brief Returns true if the board reached the goal.
+ */
+bool isSolvedPuzzle( const Board *board, PuzzleGoal goal ) {
+
+    int count = board->width * board->height;
+
+    for ( int i = 0; i < count; i++ ) {
+        if ( board->cells[i] != PIECE_NULL &&
+             ( goal.type == PUZZLE_GOAL_EMPTY_BOARD || board->cells[i] == goal.color ) ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+/**
+ * @brief Plays a swap with the puzzle rules (no refill). Returns false,
+ * leaving the board unchanged, if the swap makes no match.
+ */
+bool applyMovePuzzle( Board *board, Move move ) {
+    Cascade cascade;
+    return resolveSwapBoard( board, move, NULL, &cascade );
+}
+
+/**
+ * @brief Finds a shortest sequence of at most maxDepth swaps that takes a
+ * stable board (of at most 8 x 8 cells) to the goal. Iterative deepening
+ * search: each depth is a batch of jobs on pool, one per first move (on
+ * the calling thread when pool is NULL), and the lowest first move that
+ * solves it wins, so the answer does not depend on the scheduling.
+ * Branches are pruned when a color the goal must clear has one or two
+ * pieces left (no refill can complete them) and when a lock-free
+ * transposition table, shared by the jobs, knows the board has no
+ * solution within the moves left. table, when not NULL, is used instead
+ * of a table of PUZZLE_TABLE_BITS allocated for the solve, and keeps its
+ * entries for the next solves (they hold for any later board and goal).
+ * Returns solution->solved (always false for larger boards).
+ */
+bool solvePuzzle( const Board *board, PuzzleGoal goal, int maxDepth, ThreadPool *pool,
+                  TranspositionTable *table, PuzzleSolution *solution ) {
+
+    if ( board->width > PUZZLE_SIZE || board->height > PUZZLE_SIZE ) {
+        *solution = (PuzzleSolution) { 0 };
+        return false;
+    }
+
+    uint64_t start = getMicrosecondsTimer();
+    int workerCount = pool != NULL ? pool->threadCount : 1;
+    TranspositionTable *solveTable = table != NULL ? table : createTranspositionTable( PUZZLE_TABLE_BITS, board->width );
+    PuzzleSearch *search = createPuzzleSearch( board, goal, solveTable, workerCount, 0 );
+
+    initSolution( board, goal, solution );
+    deepenPuzzle( search, pool, 1, maxDepth < PUZZLE_MAX_DEPTH ? maxDepth : PUZZLE_MAX_DEPTH, solution );
+    destroyPuzzleSearch( search, workerCount, solution );
+
+    if ( table == NULL ) {
+        destroyTranspositionTable( solveTable );
+    }
+
+    solution->microseconds = getMicrosecondsTimer() - start;
+
+    return solution->solved;
+
+}
+
+/**
+ * @brief Starts solving a copy of a stable board (of at most 8 x 8 cells)
+ * with up to maxDepth swaps, dropping the previous solve. Nothing is
+ * searched until stepAnytimePuzzle is called; boards already at the goal
+ * or hopeless are finished at once. table must not be NULL: it keeps what
+ * a depth cut short already proved.
+ */
+void startAnytimePuzzle( AnytimePuzzle *anytime, const Board *board, PuzzleGoal goal, int maxDepth,
+                         TranspositionTable *table ) {
+
+    anytime->board = (Board) { .cells = anytime->cells };
+    copyBoard( &anytime->board, board );
+    anytime->goal = goal;
+    anytime->maxDepth = maxDepth < PUZZLE_MAX_DEPTH ? maxDepth : PUZZLE_MAX_DEPTH;
+    anytime->depth = 1;
+    anytime->table = table;
+
+    initSolution( board, goal, &anytime->solution );
+    anytime->finished = anytime->solution.solved || anytime->solution.unsolvable;
+
+}
+
+/**
+ * @brief Advances the solve for about budget microseconds, on the calling
+ * thread. A depth the budget cuts short is searched again by the next
+ * call, which skips the branches the table proved meanwhile, so every
+ * call makes progress. solution->microseconds adds up the time of the
+ * calls. Returns true once the solve finished (solved, proven unsolvable
+ * or searched up to maxDepth).
+ */
+bool stepAnytimePuzzle( AnytimePuzzle *anytime, uint64_t budget ) {
+
+    if ( anytime->finished ) {
+        return true;
+    }
+
+    uint64_t start = getMicrosecondsTimer();
+    PuzzleSearch *search = createPuzzleSearch( &anytime->board, anytime->goal, anytime->table, 1, start + budget );
+
+    anytime->depth = deepenPuzzle( search, NULL, anytime->depth, anytime->maxDepth, &anytime->solution );
+    anytime->finished = !search->timedOut;
+    destroyPuzzleSearch( search, 1, &anytime->solution );
+
+    anytime->solution.microseconds += getMicrosecondsTimer() - start;
+
+    return anytime->finished;
+
+}
@@ -0,0 +1,289 @@
+/**
+ * @file Replay.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Replay implementation.
+ *
+ * File format (all integers little-endian):
+ *     "BJRP", version (1 byte), width (2 bytes), height (2 bytes),
+ *     seed (8 bytes), move count (4 bytes), then, for each move, the frame
+ *     delta, r1 and c1 as unsigned varints and the direction of the second
+ *     cell (0: right, 1: down, 2: left, 3: up) in one byte.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Replay.h"
+#include "Rng.h"
+#include "BoardGenerator.h"
+
+// replays are played again from the seed, so the version changes with any
+// change to the boards the engine builds from it (2: reshuffles draw their
+// pieces from a pool, 3: large boards are reshuffled by regions)
+#define REPLAY_VERSION 3
+#define REPLAY_INITIAL_CAPACITY 64
+
+static const int directionRow[] = { 0, 1, 0, -1 };
+static const int directionCol[] = { 1, 0, -1, 0 };
+
+static void writeUInt( FILE *file, uint64_t value, int bytes ) {
+    for ( int i = 0; i < bytes; i++ ) {
+        fputc( (int) ( ( value >> ( i * 8 ) ) & 0xFF ), file );
+    }
+}
+
+static bool readUInt( FILE *file, uint64_t *value, int bytes ) {
+    *value = 0;
+    for ( int i = 0; i < bytes; i++ ) {
+        int c = fgetc( file );
+        if ( c == EOF ) {
+            return false;
+        }
+        *value |= (uint64_t) c << ( i * 8 );
+    }
+    return true;
+}
+
+static void writeVarint( FILE *file, uint32_t value ) {
+    while ( value >= 0x80 ) {
+        fputc( (int) ( ( value & 0x7F ) | 0x80 ), file );
+        value >>= 7;
+    }
+    fputc( (int) value, file );
+}
+
+static bool readVarint( FILE *file, uint32_t *value ) {
+    *value = 0;
+    for ( int shift = 0; shift < 35; shift += 7 ) {
+        int c = fgetc( file );
+        if ( c == EOF ) {
+            return false;
+        }
+        *value |= (uint32_t) ( c & 0x7F ) << shift;
+        if ( !( c & 0x80 ) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Creates a dinamically allocated, empty Replay struct instance.
+ */
+Replay* createReplay( uint64_t seed, int width, int height ) {
+
+    Replay *replay = (Replay*) malloc( sizeof( Replay ) );
+
+    replay->seed = seed;
+    replay->width = width;
+    replay->height = height;
+    replay->moves = (ReplayMove*) malloc( REPLAY_INITIAL_CAPACITY * sizeof( ReplayMove ) );
+    replay->moveCount = 0;
+    replay->moveCapacity = REPLAY_INITIAL_CAPACITY;
+
+    return replay;
+
+}
+
+/**
+ * @brief Destroys a Replay object and its moves.
+ */
+void destroyReplay( Replay *replay ) {
+    free( replay->moves );
+    free( replay );
+}
+
+/**
+ * @brief Removes every move and starts recording a board with a new seed.
+ */
+void clearReplay( Replay *replay, uint64_t seed ) {
+    replay->seed = seed;
+    replay->moveCount = 0;
+}
+
+/**
+ * @brief Records an accepted swap.
+ */
+void addMoveReplay( Replay *replay, uint32_t frame, Move move ) {
+
+    if ( replay->moveCount == replay->moveCapacity ) {
+        replay->moveCapacity *= 2;
+        replay->moves = (ReplayMove*) realloc( replay->moves, replay->moveCapacity * sizeof( ReplayMove ) );
+    }
+
+    replay->moves[replay->moveCount++] = (ReplayMove) {
+        .frame = frame,
+        .r1 = (uint16_t) move.r1,
+        .c1 = (uint16_t) move.c1,
+        .r2 = (uint16_t) move.r2,
+        .c2 = (uint16_t) move.c2
+    };
+
+}
+
+/**
+ * @brief Builds the initial board of a seed, exactly like the game does.
+ * The cells of board must have room for width x height cells. rng is left
+ * ready to produce the first refill.
+ */
+void buildInitialBoardReplay( Board *board, Rng *rng, uint64_t seed, int width, int height ) {
+    initBoard( board, width, height, board->cells );
+    seedRng( rng, seed, 0 );
+    generateBoard( board, rng );
+}
+
+/**
+ * @brief Re-executes every move of the replay with the headless cascade
+ * resolver, at full speed and without rendering. Boards left without legal
+ * moves are reshuffled, like the game does. The final board is stored in
+ * board, whose cells must have room for the replay board, and the totals
+ * in stats (may be NULL). Returns true if every recorded move was
+ * accepted again.
+ */
+bool playReplay( const Replay *replay, Board *board, ReplayStats *stats ) {
+
+    Rng rng;
+    Cascade cascade;
+    ReplayStats local = { 0 };
+
+    buildInitialBoardReplay( board, &rng, replay->seed, replay->width, replay->height );
+
+    for ( int i = 0; i < replay->moveCount; i++ ) {
+
+        const ReplayMove *m = &replay->moves[i];
+        Move move = { m->r1, m->c1, m->r2, m->c2 };
+
+        local.moves++;
+
+        if ( resolveSwapTotalsBoard( board, move, &rng, &cascade ) ) {
+            if ( ensureMovesBoard( board, &rng ) ) {
+                local.reshuffles++;
+            }
+            local.cascades += cascade.depth;
+            local.clearedCells += cascade.clearedCells;
+            if ( cascade.depth > local.maxDepth ) {
+                local.maxDepth = cascade.depth;
+            }
+        } else {
+            local.rejectedMoves++;
+        }
+
+    }
+
+    if ( stats != NULL ) {
+        *stats = local;
+    }
+
+    return local.rejectedMoves == 0;
+
+}
+
+/**
+ * @brief Saves the replay in a compact binary format. Returns true on
+ * success.
+ */
+bool saveReplay( const Replay *replay, const char *path ) {
+
+    FILE *file = fopen( path, "wb" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    fwrite( "BJRP", 1, 4, file );
+    writeUInt( file, REPLAY_VERSION, 1 );
+    writeUInt( file, (uint64_t) replay->width, 2 );
+    writeUInt( file, (uint64_t) replay->height, 2 );
+    writeUInt( file, replay->seed, 8 );
+    writeUInt( file, (uint64_t) replay->moveCount, 4 );
+
+    uint32_t lastFrame = 0;
+
+    for ( int i = 0; i < replay->moveCount; i++ ) {
+
+        const ReplayMove *m = &replay->moves[i];
+        int direction = 0;
+
+        for ( int d = 0; d < 4; d++ ) {
+            if ( m->r1 + directionRow[d] == m->r2 && m->c1 + directionCol[d] == m->c2 ) {
+                direction = d;
+            }
+        }
+
+        writeVarint( file, m->frame - lastFrame );
+        writeVarint( file, m->r1 );
+        writeVarint( file, m->c1 );
+        fputc( direction, file );
+        lastFrame = m->frame;
+
+    }
+
+    bool ok = !ferror( file );
+    fclose( file );
+
+    return ok;
+
+}
+
+/**
+ * @brief Loads a replay saved with saveReplay. Returns NULL on failure or
+ * when the board size is not supported.
+ */
+Replay* loadReplay( const char *path ) {
+
+    FILE *file = fopen( path, "rb" );
+
+    if ( file == NULL ) {
+        return NULL;
+    }
+
+    char magic[4];
+    uint64_t version;
+    uint64_t width;
+    uint64_t height;
+    uint64_t seed;
+    uint64_t count;
+
+    if ( fread( magic, 1, 4, file ) != 4 || memcmp( magic, "BJRP", 4 ) != 0 ||
+         !readUInt( file, &version, 1 ) || version != REPLAY_VERSION ||
+         !readUInt( file, &width, 2 ) || !readUInt( file, &height, 2 ) ||
+         !readUInt( file, &seed, 8 ) || !readUInt( file, &count, 4 ) ||
+         !isValidSizeBoard( (int) width, (int) height ) ) {
+        fclose( file );
+        return NULL;
+    }
+
+    Replay *replay = createReplay( seed, (int) width, (int) height );
+    uint32_t frame = 0;
+
+    for ( uint64_t i = 0; i < count; i++ ) {
+
+        uint32_t delta;
+        uint32_t r1;
+        uint32_t c1;
+        int direction;
+
+        if ( !readVarint( file, &delta ) || !readVarint( file, &r1 ) || !readVarint( file, &c1 ) ||
+             ( direction = fgetc( file ) ) == EOF || direction > 3 ) {
+            destroyReplay( replay );
+            fclose( file );
+            return NULL;
+        }
+
+        frame += delta;
+        addMoveReplay( replay, frame, (Move) {
+            (int) r1, (int) c1,
+            (int) r1 + directionRow[direction], (int) c1 + directionCol[direction]
+        } );
+
+    }
+
+    fclose( file );
+
+    return replay;
+
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Rng.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Rng implementation (PCG-XSH-RR 64/32, by Melissa O'Neill).
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdint.h>
+
+#include "Rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+/**
+ * @brief Seeds the generator. Generators with the same seed but different
+ * streams produce independent sequences.
+ */
+void seedRng( Rng *rng, uint64_t seed, uint64_t stream ) {
+    rng->state = 0;
+    rng->increment = ( stream << 1 ) | 1;
+    nextRng( rng );
+    rng->state += seed;
+    nextRng( rng );
+}
+
+/**
+ * @brief Returns the next 32 bit value of the sequence.
+ */
+uint32_t nextRng( Rng *rng ) {
+
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->increment;
+
+    uint32_t xorShifted = (uint32_t) ( ( ( old >> 18 ) ^ old ) >> 27 );
+    uint32_t rotation = (uint32_t) ( old >> 59 );
+
+    return ( xorShifted >> rotation ) | ( xorShifted << ( ( -rotation ) & 31 ) );
+
+}
+
+/**
+ * @brief Returns a value in [0, bound).
+ */
+int boundedRng( Rng *rng, int bound ) {
+    // multiply-shift reduction: no division and a bias below bound / 2^32
+    return (int) ( ( (uint64_t) nextRng( rng ) * (uint64_t) bound ) >> 32 );
+}
+
+/**
+ * @brief Returns a random piece type (never PIECE_NULL).
+ */
+PieceType nextPieceRng( Rng *rng ) {
+    return 1 + boundedRng( rng, PIECE_TYPE_COUNT - 1 );
+}
+
+/**
+ * @brief Fills pieces with count random piece types (never PIECE_NULL).
+ * Produces the same values as count calls to nextPieceRng.
+ */
+void fillPiecesRng( Rng *rng, uint8_t *pieces, int count ) {
+
+    // local copy of the state so the loop runs in registers
+    Rng local = *rng;
+
+    for ( int i = 0; i < count; i++ ) {
+        pieces[i] = (uint8_t) ( 1 + ( ( (uint64_t) nextRng( &local ) * ( PIECE_TYPE_COUNT - 1 ) ) >> 32 ) );
+    }
+
+    *rng = local;
+
+}
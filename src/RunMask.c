@@ -0,0 +1,378 @@
+/**
+ * @file RunMask.c
+ * @author Prof. Dr. David Buzatto
+ * @brief RunMask implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "RunMask.h"
+#include "Types.h"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define RUN_MASK_X86
+#include <immintrin.h>
+#endif
+
+static const char *kernelNames[RUN_KERNEL_COUNT] = { "scalar", "sse2", "avx2" };
+
+// the CPU is asked once, by the first scan of any thread
+static pthread_once_t bestKernelOnce = PTHREAD_ONCE_INIT;
+static RunKernel bestKernel = RUN_KERNEL_SCALAR;
+
+static void findBestKernel( void ) {
+    bestKernel = getBestKernelRunMask();
+}
+
+// true when the cell at c starts a run of three along step (1 for a row,
+// the board width for a column)
+static bool startsRun( const uint8_t *c, ptrdiff_t step ) {
+    return c[0] != PIECE_NULL && c[0] == c[step] && c[0] == c[2 * step];
+}
+
+// the mask of a single cell, used by the vector kernels for the columns
+// too close to the board edges to be loaded as a whole vector
+static uint8_t maskCell( const uint8_t *cells, int width, int height, int i, int j ) {
+
+    const uint8_t *c = cells + i * width + j;
+
+    return ( j + 2 < width && startsRun( c, 1 ) ) ||
+           ( j >= 1 && j + 1 < width && startsRun( c - 1, 1 ) ) ||
+           ( j >= 2 && startsRun( c - 2, 1 ) ) ||
+           ( i + 2 < height && startsRun( c, width ) ) ||
+           ( i >= 1 && i + 1 < height && startsRun( c - width, width ) ) ||
+           ( i >= 2 && startsRun( c - 2 * width, width ) );
+
+}
+
+// run-length row and column passes, the same rule findMatchGroups uses
+static int findScalar( const uint8_t *cells, int width, int height, uint8_t *mask ) {
+
+    int count = 0;
+
+    memset( mask, 0, (size_t) width * height );
+
+    for ( int i = 0; i < height; i++ ) {
+        const uint8_t *row = cells + i * width;
+        int start = 0;
+        while ( start < width ) {
+            int end = start + 1;
+            while ( end < width && row[end] == row[start] ) {
+                end++;
+            }
+            if ( row[start] != PIECE_NULL && end - start >= 3 ) {
+                memset( mask + i * width + start, 1, end - start );
+            }
+            start = end;
+        }
+    }
+
+    for ( int j = 0; j < width; j++ ) {
+        int start = 0;
+        while ( start < height ) {
+            uint8_t type = cells[start * width + j];
+            int end = start + 1;
+            while ( end < height && cells[end * width + j] == type ) {
+                end++;
+            }
+            if ( type != PIECE_NULL && end - start >= 3 ) {
+                for ( int i = start; i < end; i++ ) {
+                    mask[i * width + j] = 1;
+                }
+            }
+            start = end;
+        }
+    }
+
+    for ( int k = 0; k < width * height; k++ ) {
+        count += mask[k];
+    }
+
+    return count;
+
+}
+
+// masks the edge columns of row i (those before first and from last on)
+// one cell at a time
+static int maskEdges( const uint8_t *cells, int width, int height, int i, int first, int last, uint8_t *mask ) {
+
+    int count = 0;
+
+    for ( int j = 0; j < first && j < width; j++ ) {
+        mask[i * width + j] = maskCell( cells, width, height, i, j );
+        count += mask[i * width + j];
+    }
+
+    for ( int j = last; j < width; j++ ) {
+        mask[i * width + j] = maskCell( cells, width, height, i, j );
+        count += mask[i * width + j];
+    }
+
+    return count;
+
+}
+
+#ifdef RUN_MASK_X86
+
+/*
+ * The vector kernels compute the mask of a whole row block at once. A cell
+ * is in a run when a run of three starts at it, or one or two cells before
+ * it, along its row or its column. Along the row the starts come from the
+ * block loaded at offsets -2 to +2; along the column from the same block
+ * of the two rows above and below (compared lane by lane, so vertical runs
+ * need no transposition).
+ */
+
+__attribute__(( target( "sse2" ), always_inline ))
+static inline __m128i startsSse2( __m128i a, __m128i b, __m128i c, __m128i zero ) {
+    __m128i equal = _mm_and_si128( _mm_cmpeq_epi8( a, b ), _mm_cmpeq_epi8( b, c ) );
+    return _mm_andnot_si128( _mm_cmpeq_epi8( a, zero ), equal );
+}
+
+// the run lanes of the block of row i starting at c
+__attribute__(( target( "sse2" ), always_inline ))
+static inline __m128i blockSse2( const uint8_t *c, int width, int height, int i ) {
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i x0 = _mm_loadu_si128( (const __m128i *) ( c - 2 ) );
+    __m128i x1 = _mm_loadu_si128( (const __m128i *) ( c - 1 ) );
+    __m128i x2 = _mm_loadu_si128( (const __m128i *) c );
+    __m128i x3 = _mm_loadu_si128( (const __m128i *) ( c + 1 ) );
+    __m128i x4 = _mm_loadu_si128( (const __m128i *) ( c + 2 ) );
+
+    __m128i runs = _mm_or_si128( startsSse2( x2, x3, x4, zero ),
+               _mm_or_si128( startsSse2( x1, x2, x3, zero ), startsSse2( x0, x1, x2, zero ) ) );
+
+    __m128i up1 = zero;
+    __m128i down1 = zero;
+
+    if ( i >= 1 ) {
+        up1 = _mm_loadu_si128( (const __m128i *) ( c - width ) );
+    }
+    if ( i + 1 < height ) {
+        down1 = _mm_loadu_si128( (const __m128i *) ( c + width ) );
+    }
+    if ( i + 2 < height ) {
+        __m128i down2 = _mm_loadu_si128( (const __m128i *) ( c + 2 * width ) );
+        runs = _mm_or_si128( runs, startsSse2( x2, down1, down2, zero ) );
+    }
+    if ( i >= 1 && i + 1 < height ) {
+        runs = _mm_or_si128( runs, startsSse2( up1, x2, down1, zero ) );
+    }
+    if ( i >= 2 ) {
+        __m128i up2 = _mm_loadu_si128( (const __m128i *) ( c - 2 * width ) );
+        runs = _mm_or_si128( runs, startsSse2( up2, up1, x2, zero ) );
+    }
+
+    return runs;
+
+}
+
+__attribute__(( target( "sse2" ) ))
+static int findSse2( const uint8_t *cells, int width, int height, uint8_t *mask ) {
+
+    const int lanes = 16;
+    const __m128i one = _mm_set1_epi8( 1 );
+    int count = 0;
+
+    // narrower boards have no full block between the edge columns
+    if ( width < lanes + 4 ) {
+        return findScalar( cells, width, height, mask );
+    }
+
+    for ( int i = 0; i < height; i++ ) {
+
+        const uint8_t *row = cells + i * width;
+        uint8_t *out = mask + i * width;
+        int j = 2;
+
+        for ( ; j + lanes + 2 <= width; j += lanes ) {
+            __m128i runs = blockSse2( row + j, width, height, i );
+            _mm_storeu_si128( (__m128i *) ( out + j ), _mm_and_si128( runs, one ) );
+            count += __builtin_popcount( (unsigned) _mm_movemask_epi8( runs ) );
+        }
+
+        // the last block overlaps the previous one, whose lanes are
+        // stored again with the same values but not counted twice
+        if ( j < width - 2 ) {
+            int last = width - 2 - lanes;
+            __m128i runs = blockSse2( row + last, width, height, i );
+            _mm_storeu_si128( (__m128i *) ( out + last ), _mm_and_si128( runs, one ) );
+            count += __builtin_popcount( (unsigned) _mm_movemask_epi8( runs ) >> ( j - last ) );
+        }
+
+        count += maskEdges( cells, width, height, i, 2, width - 2, mask );
+
+    }
+
+    return count;
+
+}
+
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i startsAvx2( __m256i a, __m256i b, __m256i c, __m256i zero ) {
+    __m256i equal = _mm256_and_si256( _mm256_cmpeq_epi8( a, b ), _mm256_cmpeq_epi8( b, c ) );
+    return _mm256_andnot_si256( _mm256_cmpeq_epi8( a, zero ), equal );
+}
+
+// the run lanes of the block of row i starting at c
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i blockAvx2( const uint8_t *c, int width, int height, int i ) {
+
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i x0 = _mm256_loadu_si256( (const __m256i *) ( c - 2 ) );
+    __m256i x1 = _mm256_loadu_si256( (const __m256i *) ( c - 1 ) );
+    __m256i x2 = _mm256_loadu_si256( (const __m256i *) c );
+    __m256i x3 = _mm256_loadu_si256( (const __m256i *) ( c + 1 ) );
+    __m256i x4 = _mm256_loadu_si256( (const __m256i *) ( c + 2 ) );
+
+    __m256i runs = _mm256_or_si256( startsAvx2( x2, x3, x4, zero ),
+               _mm256_or_si256( startsAvx2( x1, x2, x3, zero ), startsAvx2( x0, x1, x2, zero ) ) );
+
+    __m256i up1 = zero;
+    __m256i down1 = zero;
+
+    if ( i >= 1 ) {
+        up1 = _mm256_loadu_si256( (const __m256i *) ( c - width ) );
+    }
+    if ( i + 1 < height ) {
+        down1 = _mm256_loadu_si256( (const __m256i *) ( c + width ) );
+    }
+    if ( i + 2 < height ) {
+        __m256i down2 = _mm256_loadu_si256( (const __m256i *) ( c + 2 * width ) );
+        runs = _mm256_or_si256( runs, startsAvx2( x2, down1, down2, zero ) );
+    }
+    if ( i >= 1 && i + 1 < height ) {
+        runs = _mm256_or_si256( runs, startsAvx2( up1, x2, down1, zero ) );
+    }
+    if ( i >= 2 ) {
+        __m256i up2 = _mm256_loadu_si256( (const __m256i *) ( c - 2 * width ) );
+        runs = _mm256_or_si256( runs, startsAvx2( up2, up1, x2, zero ) );
+    }
+
+    return runs;
+
+}
+
+__attribute__(( target( "avx2" ) ))
+static int findAvx2( const uint8_t *cells, int width, int height, uint8_t *mask ) {
+
+    const int lanes = 32;
+    const __m256i one = _mm256_set1_epi8( 1 );
+    int count = 0;
+
+    // narrower boards have no full block between the edge columns
+    if ( width < lanes + 4 ) {
+        return findScalar( cells, width, height, mask );
+    }
+
+    for ( int i = 0; i < height; i++ ) {
+
+        const uint8_t *row = cells + i * width;
+        uint8_t *out = mask + i * width;
+        int j = 2;
+
+        for ( ; j + lanes + 2 <= width; j += lanes ) {
+            __m256i runs = blockAvx2( row + j, width, height, i );
+            _mm256_storeu_si256( (__m256i *) ( out + j ), _mm256_and_si256( runs, one ) );
+            count += __builtin_popcount( (unsigned) _mm256_movemask_epi8( runs ) );
+        }
+
+        // the last block overlaps the previous one, whose lanes are
+        // stored again with the same values but not counted twice
+        if ( j < width - 2 ) {
+            int last = width - 2 - lanes;
+            __m256i runs = blockAvx2( row + last, width, height, i );
+            _mm256_storeu_si256( (__m256i *) ( out + last ), _mm256_and_si256( runs, one ) );
+            count += __builtin_popcount( (unsigned) _mm256_movemask_epi8( runs ) >> ( j - last ) );
+        }
+
+        count += maskEdges( cells, width, height, i, 2, width - 2, mask );
+
+    }
+
+    return count;
+
+}
+
+#endif
+
+/**
+ * @brief Returns true if the kernel was compiled in and the CPU running
+ * the program supports it. The scalar kernel is always supported.
+ */
+bool isSupportedKernelRunMask( RunKernel kernel ) {
+
+    switch ( kernel ) {
+        case RUN_KERNEL_SCALAR:
+            return true;
+#ifdef RUN_MASK_X86
+        case RUN_KERNEL_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports( "sse2" );
+        case RUN_KERNEL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports( "avx2" );
+#endif
+        default:
+            return false;
+    }
+
+}
+
+/**
+ * @brief Returns the fastest kernel the CPU supports.
+ */
+RunKernel getBestKernelRunMask( void ) {
+
+    for ( int kernel = RUN_KERNEL_COUNT - 1; kernel > RUN_KERNEL_SCALAR; kernel-- ) {
+        if ( isSupportedKernelRunMask( kernel ) ) {
+            return kernel;
+        }
+    }
+
+    return RUN_KERNEL_SCALAR;
+
+}
+
+/**
+ * @brief Returns the name of a kernel.
+ */
+const char *getKernelNameRunMask( RunKernel kernel ) {
+    return kernel >= 0 && kernel < RUN_KERNEL_COUNT ? kernelNames[kernel] : "unknown";
+}
+
+/**
+ * @brief Stores in mask (width * height bytes) 1 for every cell of cells
+ * that belongs to a run of three or more equal pieces and 0 for the
+ * others. PIECE_NULL cells never match. Returns how many cells were
+ * marked. Uses the fastest kernel the CPU supports, picked on the first call.
+ */
+int findRunMask( const uint8_t *cells, int width, int height, uint8_t *mask ) {
+    pthread_once( &bestKernelOnce, findBestKernel );
+    return findWithKernelRunMask( bestKernel, cells, width, height, mask );
+}
+
+/**
+ * @brief Same as findRunMask, with the given kernel, which must be
+ * supported. Every kernel produces exactly the same mask.
+ */
+int findWithKernelRunMask( RunKernel kernel, const uint8_t *cells, int width, int height, uint8_t *mask ) {
+
+    switch ( kernel ) {
+#ifdef RUN_MASK_X86
+        case RUN_KERNEL_SSE2:
+            return findSse2( cells, width, height, mask );
+        case RUN_KERNEL_AVX2:
+            return findAvx2( cells, width, height, mask );
+#endif
+        default:
+            return findScalar( cells, width, height, mask );
+    }
+
+}
@@ -0,0 +1,411 @@
+/**
+ * @file Search.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Search implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Search.h"
+#include "BitBoard.h"
+#include "Rng.h"
+#include "Timer.h"
+#include "Zobrist.h"
+
+static float evaluateMove( Search *search, const Board *board, uint64_t hash, Move move, int ply );
+
+static bool fitsSearch( const Board *board ) {
+    return board->width <= BITBOARD_SIZE && board->height <= BITBOARD_SIZE;
+}
+
+static bool hasMove( const Move *moves, int moveCount, Move move ) {
+    for ( int i = 0; i < moveCount; i++ ) {
+        if ( moves[i].r1 == move.r1 && moves[i].c1 == move.c1 &&
+             moves[i].r2 == move.r2 && moves[i].c2 == move.c2 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// expected score of the best move of a stable board
+static float evaluateBoard( Search *search, const Board *board, uint64_t hash, int ply ) {
+
+    int remaining = search->config.depth - ply;
+    TableProbe probe;
+
+    if ( search->table != NULL && probeTranspositionTable( search->table, hash, &probe ) &&
+         probe.depth == remaining ) {
+        search->tableHits++;
+        return probe.value;
+    }
+
+    Move *moves = search->moves[ply];
+    int moveCount = listMovesSearch( board, moves );
+    float best = 0;
+    Move bestMove = { 0, 0, 0, 0 };
+
+    for ( int i = 0; i < moveCount; i++ ) {
+        float value = evaluateMove( search, board, hash, moves[i], ply );
+        if ( value > best ) {
+            best = value;
+            bestMove = moves[i];
+        }
+    }
+
+    if ( search->table != NULL ) {
+        storeTranspositionTable( search->table, hash, best, remaining, bestMove );
+    }
+
+    return best;
+
+}
+
+// chance node: average over the sampled refills of the cells the move
+// clears plus the value of the best continuation. Sample s of a ply always
+// uses the same random stream, so sibling moves are compared under the
+// same refills and the comparison has much less noise
+static float evaluateMove( Search *search, const Board *board, uint64_t hash, Move move, int ply ) {
+
+    float total = 0;
+
+    for ( int s = 0; s < search->config.samples; s++ ) {
+
+        uint8_t cells[BITBOARD_CELLS];
+        Board child = { .cells = cells };
+        Rng rng;
+
+        copyBoard( &child, board );
+        seedRng( &rng, search->config.seed + (uint64_t) ply, (uint64_t) s );
+        resolveSwapBoard( &child, move, &rng, &search->cascade );
+        search->nodes++;
+
+        float value = (float) search->cascade.clearedCells;
+        if ( ply + 1 < search->config.depth ) {
+            value += evaluateBoard( search, &child, hash ^ search->cascade.hashDelta, ply + 1 );
+        }
+
+        total += value;
+
+    }
+
+    return total / search->config.samples;
+
+}
+
+// the root is stored under its Zobrist hash like any other node. Its value
+// depends on the refills drawn for this search, which come from the seeded
+// streams by cell and color, so a relabelled or mirrored board only has the
+// same expected value over the refills, not the same samples, and cannot
+// share the entry. A hash collision could bring a move of another board, so
+// the stored move is only used if it is legal here
+static bool probeRoot( Search *search, uint64_t hash, const Move *moves, int moveCount, SearchResult *result ) {
+
+    TableProbe probe;
+
+    if ( search->table != NULL && probeTranspositionTable( search->table, hash, &probe ) &&
+         probe.depth == search->config.depth && hasMove( moves, moveCount, probe.bestMove ) ) {
+        search->tableHits++;
+        result->found = true;
+        result->move = probe.bestMove;
+        result->expectedScore = probe.value;
+        return true;
+    }
+
+    return false;
+
+}
+
+static void storeRoot( Search *search, uint64_t hash, const SearchResult *result ) {
+    if ( result->found && search->table != NULL ) {
+        storeTranspositionTable( search->table, hash, result->expectedScore, search->config.depth, result->move );
+    }
+}
+
+/**
+ * @brief Prepares a search with the given configuration, clamping depth
+ * and samples to the supported ranges. table may be NULL.
+ */
+void initSearch( Search *search, SearchConfig config, TranspositionTable *table ) {
+
+    if ( config.depth < 1 ) {
+        config.depth = 1;
+    } else if ( config.depth > SEARCH_MAX_DEPTH ) {
+        config.depth = SEARCH_MAX_DEPTH;
+    }
+
+    if ( config.samples < 1 ) {
+        config.samples = 1;
+    } else if ( config.samples > SEARCH_MAX_SAMPLES ) {
+        config.samples = SEARCH_MAX_SAMPLES;
+    }
+
+    search->config = config;
+    search->table = table;
+    search->nodes = 0;
+    search->tableHits = 0;
+
+}
+
+/**
+ * @brief Lists the legal moves of a stable board in moves, returning how
+ * many there are. Boards larger than 8 x 8 cells are not searched and
+ * get no moves.
+ */
+int listMovesSearch( const Board *board, Move *moves ) {
+
+    BitBoard bb;
+    MoveSet moveSet;
+
+    if ( !fitsSearch( board ) ) {
+        return 0;
+    }
+
+    loadBitBoard( &bb, board );
+    findMovesBitBoard( &bb, &moveSet );
+
+    return listMovesBitBoard( &moveSet, moves, SEARCH_MOVE_CAPACITY );
+
+}
+
+/**
+ * @brief Evaluates every legal move of a stable board and stores the one
+ * with the highest expected score (cells cleared over the next
+ * config.depth moves) in result. Returns false when the board has no
+ * legal move.
+ */
+bool findBestMoveSearch( Search *search, const Board *board, SearchResult *result ) {
+
+    Move *moves = search->moves[0];
+    int moveCount = listMovesSearch( board, moves );
+    uint64_t hash = hashBoardZobrist( board );
+
+    search->nodes = 0;
+    search->tableHits = 0;
+    result->found = false;
+    result->expectedScore = 0;
+    result->depth = search->config.depth;
+    result->moveCount = moveCount;
+
+    if ( moveCount > 0 && !probeRoot( search, hash, moves, moveCount, result ) ) {
+        for ( int i = 0; i < moveCount; i++ ) {
+            float value = evaluateMove( search, board, hash, moves[i], 0 );
+            if ( !result->found || value > result->expectedScore ) {
+                result->found = true;
+                result->move = moves[i];
+                result->expectedScore = value;
+            }
+        }
+        storeRoot( search, hash, result );
+    }
+
+    result->nodes = search->nodes;
+    result->tableHits = search->tableHits;
+
+    return result->found;
+
+}
+
+// pushes the board reached at ply on the anytime stack. Returns false,
+// with its value in value, when the table already knows the board
+static bool enterAnytime( AnytimeSearch *anytime, const Board *board, uint64_t hash, int ply, float *value ) {
+
+    Search *search = &anytime->search;
+    AnytimeFrame *frame = &anytime->frames[ply];
+    TableProbe probe;
+
+    if ( ply > 0 && search->table != NULL && probeTranspositionTable( search->table, hash, &probe ) &&
+         probe.depth == search->config.depth - ply ) {
+        search->tableHits++;
+        *value = probe.value;
+        return false;
+    }
+
+    loadPackedBoard( &frame->board, board );
+    frame->hash = hash;
+    frame->moveCount = listMovesSearch( board, search->moves[ply] );
+    frame->moveIndex = 0;
+    frame->sample = 0;
+    frame->total = 0;
+    frame->best = 0;
+    frame->bestMove = (Move) { 0, 0, 0, 0 };
+    anytime->ply = ply;
+
+    return true;
+
+}
+
+// adds the value of a sample to the move being evaluated at ply; once
+// every sample is in, the move is compared exactly as evaluateBoard and
+// findBestMoveSearch do, so the values are the same as theirs
+static void addSampleAnytime( AnytimeSearch *anytime, int ply, float value ) {
+
+    AnytimeFrame *frame = &anytime->frames[ply];
+    int samples = anytime->search.config.samples;
+
+    frame->total += value;
+
+    if ( ++frame->sample == samples ) {
+        float average = frame->total / samples;
+        if ( ( ply == 0 && frame->moveIndex == 0 ) || average > frame->best ) {
+            frame->best = average;
+            frame->bestMove = anytime->search.moves[ply][frame->moveIndex];
+        }
+        frame->moveIndex++;
+        frame->sample = 0;
+        frame->total = 0;
+    }
+
+}
+
+// the root finished a depth: its answer becomes the best move and the
+// next depth starts over, or the search ends
+static void finishDepthAnytime( AnytimeSearch *anytime ) {
+
+    Search *search = &anytime->search;
+    AnytimeFrame *root = &anytime->frames[0];
+    uint8_t cells[BITBOARD_CELLS];
+    Board board = { .cells = cells };
+    float value;
+
+    anytime->best.found = true;
+    anytime->best.move = root->bestMove;
+    anytime->best.expectedScore = root->best;
+    anytime->best.depth = anytime->depth;
+    anytime->best.nodes = search->nodes;
+    anytime->best.tableHits = search->tableHits;
+
+    storePackedBoard( &root->board, &board );
+
+    if ( anytime->depth == anytime->maxDepth ) {
+        storeRoot( search, root->hash, &anytime->best );
+        anytime->finished = true;
+    } else {
+        search->config.depth = ++anytime->depth;
+        enterAnytime( anytime, &board, root->hash, 0, &value );
+    }
+
+}
+
+/**
+ * @brief Prepares an anytime search that deepens up to config.depth. It
+ * does nothing until startAnytimeSearch gives it a board.
+ */
+void initAnytimeSearch( AnytimeSearch *anytime, SearchConfig config, TranspositionTable *table ) {
+
+    initSearch( &anytime->search, config, table );
+    anytime->maxDepth = anytime->search.config.depth;
+    anytime->finished = true;
+    anytime->best = (SearchResult) { 0 };
+
+}
+
+/**
+ * @brief Starts searching a new stable board, dropping the previous one.
+ * The first legal move is available as the current best move right away.
+ */
+void startAnytimeSearch( AnytimeSearch *anytime, const Board *board ) {
+
+    Search *search = &anytime->search;
+    float value;
+
+    search->nodes = 0;
+    search->tableHits = 0;
+    search->config.depth = anytime->maxDepth;
+
+    if ( !fitsSearch( board ) ) {
+        anytime->best = (SearchResult) { 0 };
+        anytime->finished = true;
+        return;
+    }
+
+    uint64_t hash = hashBoardZobrist( board );
+    enterAnytime( anytime, board, hash, 0, &value );
+
+    int moveCount = anytime->frames[0].moveCount;
+    anytime->best = (SearchResult) {
+        .found = moveCount > 0,
+        .move = search->moves[0][0],
+        .moveCount = moveCount
+    };
+    anytime->finished = moveCount == 0;
+
+    // a board already searched to the full depth is answered at once
+    if ( !anytime->finished && probeRoot( search, hash, search->moves[0], moveCount, &anytime->best ) ) {
+        anytime->best.depth = anytime->maxDepth;
+        anytime->finished = true;
+    }
+
+    anytime->depth = 1;
+    search->config.depth = 1;
+
+}
+
+/**
+ * @brief Advances the search for about budget microseconds. The search
+ * keeps its own stack of boards instead of recursing, so it can stop
+ * after any single cascade and resume from there on the next call. Each
+ * completed depth replaces the best move. Returns true once the search
+ * reached config.depth.
+ */
+bool stepAnytimeSearch( AnytimeSearch *anytime, uint64_t budget ) {
+
+    Search *search = &anytime->search;
+    uint64_t start = getMicrosecondsTimer();
+    int steps = 0;
+
+    while ( !anytime->finished ) {
+
+        int ply = anytime->ply;
+        AnytimeFrame *frame = &anytime->frames[ply];
+
+        if ( frame->moveIndex == frame->moveCount ) {
+
+            // every move of this board is known: store it and hand its
+            // value to the sample of the parent that reached it
+            if ( ply == 0 ) {
+                finishDepthAnytime( anytime );
+            } else {
+                if ( search->table != NULL ) {
+                    storeTranspositionTable( search->table, frame->hash, frame->best,
+                                             search->config.depth - ply, frame->bestMove );
+                }
+                anytime->ply = ply - 1;
+                addSampleAnytime( anytime, ply - 1, anytime->frames[ply - 1].cleared + frame->best );
+            }
+
+        } else {
+
+            uint8_t cells[BITBOARD_CELLS];
+            Board child = { .cells = cells };
+            Rng rng;
+            float value;
+
+            storePackedBoard( &frame->board, &child );
+            seedRng( &rng, search->config.seed + (uint64_t) ply, (uint64_t) frame->sample );
+            resolveSwapBoard( &child, search->moves[ply][frame->moveIndex], &rng, &search->cascade );
+            search->nodes++;
+
+            frame->cleared = (float) search->cascade.clearedCells;
+
+            if ( ply + 1 >= search->config.depth ) {
+                addSampleAnytime( anytime, ply, frame->cleared );
+            } else if ( !enterAnytime( anytime, &child, frame->hash ^ search->cascade.hashDelta, ply + 1, &value ) ) {
+                addSampleAnytime( anytime, ply, frame->cleared + value );
+            }
+
+        }
+
+        // reading the clock costs about as much as a cascade
+        if ( ++steps % 16 == 0 && getMicrosecondsTimer() - start >= budget ) {
+            break;
+        }
+
+    }
+
+    return anytime->finished;
+
+}
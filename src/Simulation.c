@@ -0,0 +1,283 @@
+/**
+ * @file Simulation.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Simulation.h"
+#include "BitBoard.h"
+#include "BoardGenerator.h"
+#include "Cascade.h"
+#include "Replay.h"
+#include "Search.h"
+#include "Timer.h"
+
+typedef struct SimulationBatch {
+    const SimulationConfig *config;
+    uint64_t seed;
+    SimulationStats *workerStats;
+    int *movesPerGame;
+} SimulationBatch;
+
+static int chooseFirstMove( const Board *board, const Move *moves, int moveCount, Rng *rng, const void *data ) {
+    return 0;
+}
+
+static int chooseRandomMove( const Board *board, const Move *moves, int moveCount, Rng *rng, const void *data ) {
+    return boundedRng( rng, moveCount );
+}
+
+// the move that clears the most cells, looking only at the pieces already
+// on the board (refills are unknown to a player), ties broken at random
+static int chooseGreedyMove( const Board *board, const Move *moves, int moveCount, Rng *rng, const void *data ) {
+
+    uint8_t cells[BITBOARD_CELLS];
+    Board copy = { .cells = cells };
+    Cascade cascade;
+    int best = 0;
+    int bestCleared = -1;
+    int ties = 0;
+
+    for ( int i = 0; i < moveCount; i++ ) {
+
+        copyBoard( &copy, board );
+        resolveSwapBoard( &copy, moves[i], NULL, &cascade );
+
+        if ( cascade.clearedCells > bestCleared ) {
+            best = i;
+            bestCleared = cascade.clearedCells;
+            ties = 1;
+        } else if ( cascade.clearedCells == bestCleared && boundedRng( rng, ++ties ) == 0 ) {
+            best = i;
+        }
+
+    }
+
+    return best;
+
+}
+
+// expectimax search, with a search seed drawn from the game's policy rng
+static int chooseExpectimaxMove( const Board *board, const Move *moves, int moveCount, Rng *rng, const void *data ) {
+
+    Search search;
+    SearchConfig config = *(const SearchConfig*) data;
+    SearchResult result;
+
+    config.seed = nextRng( rng );
+    initSearch( &search, config, NULL );
+    findBestMoveSearch( &search, board, &result );
+
+    for ( int i = 0; i < moveCount; i++ ) {
+        if ( moves[i].r1 == result.move.r1 && moves[i].c1 == result.move.c1 &&
+             moves[i].r2 == result.move.r2 && moves[i].c2 == result.move.c2 ) {
+            return i;
+        }
+    }
+
+    return 0;
+
+}
+
+static const SearchConfig expectimaxConfig = { 2, 4, 0 };
+
+static const MovePolicy policies[] = {
+    { "first", "the first legal move in row-major order", chooseFirstMove, NULL },
+    { "random", "a uniformly random legal move", chooseRandomMove, NULL },
+    { "greedy", "the move that clears the most visible cells", chooseGreedyMove, NULL },
+    { "expectimax", "expectimax search, 2 moves deep, 4 refills per chance node", chooseExpectimaxMove, &expectimaxConfig }
+};
+
+static int listMoves( const Board *board, Move *moves ) {
+
+    BitBoard bb;
+    MoveSet moveSet;
+
+    loadBitBoard( &bb, board );
+    findMovesBitBoard( &bb, &moveSet );
+
+    return listMovesBitBoard( &moveSet, moves, SIMULATION_MOVE_CAPACITY );
+
+}
+
+static void playGameJob( void *data, int job, int worker ) {
+
+    SimulationBatch *batch = (SimulationBatch*) data;
+    int moves = playGameSimulation( batch->config, batch->seed + (uint64_t) job, &batch->workerStats[worker] );
+
+    if ( batch->movesPerGame != NULL ) {
+        batch->movesPerGame[job] = moves;
+    }
+
+}
+
+/**
+ * @brief Returns the policy with the given name, or NULL if there is none.
+ */
+const MovePolicy *findMovePolicy( const char *name ) {
+
+    int count;
+    const MovePolicy *list = getMovePolicies( &count );
+
+    for ( int i = 0; i < count; i++ ) {
+        if ( strcmp( list[i].name, name ) == 0 ) {
+            return &list[i];
+        }
+    }
+
+    return NULL;
+
+}
+
+/**
+ * @brief Returns the available policies, storing how many there are in
+ * count.
+ */
+const MovePolicy *getMovePolicies( int *count ) {
+    *count = sizeof( policies ) / sizeof( policies[0] );
+    return policies;
+}
+
+/**
+ * @brief Resets every counter of the statistics.
+ */
+void clearSimulationStats( SimulationStats *stats ) {
+    memset( stats, 0, sizeof( SimulationStats ) );
+}
+
+/**
+ * @brief Adds the counters of src to dst.
+ */
+void mergeSimulationStats( SimulationStats *dst, const SimulationStats *src ) {
+
+    if ( src->games == 0 ) {
+        return;
+    }
+
+    if ( dst->games == 0 || src->minMoves < dst->minMoves ) {
+        dst->minMoves = src->minMoves;
+    }
+
+    if ( dst->games == 0 || src->maxMoves > dst->maxMoves ) {
+        dst->maxMoves = src->maxMoves;
+    }
+
+    dst->games += src->games;
+    dst->moves += src->moves;
+    dst->reshuffles += src->reshuffles;
+    dst->clearedCells += src->clearedCells;
+
+    for ( int i = 0; i < SIMULATION_DEPTH_BUCKETS; i++ ) {
+        dst->depth[i] += src->depth[i];
+    }
+
+    for ( int i = 0; i <= MATCH_SHAPE_CROSS; i++ ) {
+        dst->shapes[i] += src->shapes[i];
+    }
+
+    dst->policyMicroseconds += src->policyMicroseconds;
+    dst->resolveMicroseconds += src->resolveMicroseconds;
+
+}
+
+/**
+ * @brief Plays a complete game from the board that seed generates (the
+ * same board a replay with this seed starts from). The game ends when the
+ * board runs out of moves or after config->maxMoves moves; with
+ * config->reshuffle the board is reshuffled like in the game instead, so
+ * only the move limit ends it. Adds the game to stats and returns how many
+ * moves were played.
+ */
+int playGameSimulation( const SimulationConfig *config, uint64_t seed, SimulationStats *stats ) {
+
+    uint8_t cells[BITBOARD_CELLS];
+    Board board = { .cells = cells };
+    Rng rng;
+    Rng policyRng;
+    Cascade cascade;
+    Move moves[SIMULATION_MOVE_CAPACITY];
+    SimulationStats game;
+    int played = 0;
+
+    // counted locally and merged once, so workers playing at the same time
+    // do not keep writing to neighboring statistics
+    clearSimulationStats( &game );
+
+    buildInitialBoardReplay( &board, &rng, seed, config->width, config->height );
+    seedRng( &policyRng, seed, 1 );
+
+    while ( played < config->maxMoves ) {
+
+        int moveCount = listMoves( &board, moves );
+
+        if ( moveCount == 0 ) {
+            break;
+        }
+
+        uint64_t start = getMicrosecondsTimer();
+        Move move = moves[config->policy->choose( &board, moves, moveCount, &policyRng, config->policy->data )];
+        uint64_t chosen = getMicrosecondsTimer();
+        resolveSwapBoard( &board, move, &rng, &cascade );
+        if ( config->reshuffle && ensureMovesBoard( &board, &rng ) ) {
+            game.reshuffles++;
+        }
+        uint64_t resolved = getMicrosecondsTimer();
+
+        game.policyMicroseconds += chosen - start;
+        game.resolveMicroseconds += resolved - chosen;
+        game.clearedCells += cascade.clearedCells;
+        game.depth[cascade.depth < SIMULATION_DEPTH_BUCKETS ? cascade.depth : SIMULATION_DEPTH_BUCKETS - 1]++;
+        for ( int i = 0; i <= MATCH_SHAPE_CROSS; i++ ) {
+            game.shapes[i] += cascade.shapes[i];
+        }
+
+        played++;
+
+    }
+
+    game.games = 1;
+    game.moves = played;
+    game.minMoves = played;
+    game.maxMoves = played;
+    mergeSimulationStats( stats, &game );
+
+    return played;
+
+}
+
+/**
+ * @brief Plays gameCount games on the pool, game i using seed + i, and
+ * stores their combined statistics in stats. Each worker gathers its own
+ * statistics, merged at the end, so workers never wait for each other.
+ * When movesPerGame is not NULL it receives the moves of each game.
+ */
+void runSimulation( ThreadPool *pool, const SimulationConfig *config, uint64_t seed, int gameCount,
+                    SimulationStats *stats, int *movesPerGame ) {
+
+    SimulationBatch batch = {
+        .config = config,
+        .seed = seed,
+        .workerStats = (SimulationStats*) malloc( pool->threadCount * sizeof( SimulationStats ) ),
+        .movesPerGame = movesPerGame
+    };
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        clearSimulationStats( &batch.workerStats[i] );
+    }
+
+    runThreadPool( pool, gameCount, playGameJob, &batch );
+
+    clearSimulationStats( stats );
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        mergeSimulationStats( stats, &batch.workerStats[i] );
+    }
+
+    free( batch.workerStats );
+
+}
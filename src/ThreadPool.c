@@ -0,0 +1,230 @@
+/**
+ * @file ThreadPool.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ThreadPool implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ThreadPool.h"
+
+typedef struct WorkerStart {
+    ThreadPool *pool;
+    int worker;
+} WorkerStart;
+
+// takes the next job of the worker's own range
+static bool takeJob( JobRange *range, int *job ) {
+
+    bool taken = false;
+
+    pthread_mutex_lock( &range->lock );
+    if ( range->next < range->end ) {
+        *job = range->next++;
+        taken = true;
+    }
+    pthread_mutex_unlock( &range->lock );
+
+    return taken;
+
+}
+
+// moves half of the jobs left in some other range (rounded up) to the
+// worker's own range, trying the workers after it in turn
+static bool stealJobs( ThreadPool *pool, int worker ) {
+
+    for ( int i = 1; i < pool->threadCount; i++ ) {
+
+        JobRange *victim = &pool->ranges[( worker + i ) % pool->threadCount];
+        int first = 0;
+        int end = 0;
+
+        pthread_mutex_lock( &victim->lock );
+        if ( victim->next < victim->end ) {
+            end = victim->end;
+            first = end - ( end - victim->next + 1 ) / 2;
+            victim->end = first;
+        }
+        pthread_mutex_unlock( &victim->lock );
+
+        if ( first < end ) {
+            JobRange *own = &pool->ranges[worker];
+            pthread_mutex_lock( &own->lock );
+            own->next = first;
+            own->end = end;
+            pthread_mutex_unlock( &own->lock );
+            return true;
+        }
+
+    }
+
+    return false;
+
+}
+
+static void *runWorker( void *arg ) {
+
+    WorkerStart start = *(WorkerStart*) arg;
+    ThreadPool *pool = start.pool;
+    int seenBatch = 0;
+
+    free( arg );
+
+    pthread_mutex_lock( &pool->lock );
+
+    while ( true ) {
+
+        while ( !pool->stopping && pool->batch == seenBatch ) {
+            pthread_cond_wait( &pool->batchReady, &pool->lock );
+        }
+
+        if ( pool->stopping ) {
+            break;
+        }
+
+        seenBatch = pool->batch;
+        pthread_mutex_unlock( &pool->lock );
+
+        // jobs being moved by a thief are always run by that thief, so a
+        // worker that finds nothing to steal can stop
+        int job;
+        do {
+            while ( takeJob( &pool->ranges[start.worker], &job ) ) {
+                pool->function( pool->data, job, start.worker );
+            }
+        } while ( stealJobs( pool, start.worker ) );
+
+        pthread_mutex_lock( &pool->lock );
+        if ( --pool->activeWorkers == 0 ) {
+            pthread_cond_signal( &pool->batchDone );
+        }
+
+    }
+
+    pthread_mutex_unlock( &pool->lock );
+
+    return NULL;
+
+}
+
+/**
+ * @brief Creates a dinamically allocated ThreadPool with threadCount
+ * workers (all available cores when threadCount <= 0).
+ */
+ThreadPool* createThreadPool( int threadCount ) {
+
+    ThreadPool *pool = (ThreadPool*) calloc( 1, sizeof( ThreadPool ) );
+
+    pool->threadCount = threadCount > 0 ? threadCount : getCoreCount();
+    pool->threads = (pthread_t*) malloc( pool->threadCount * sizeof( pthread_t ) );
+    pool->ranges = (JobRange*) calloc( pool->threadCount, sizeof( JobRange ) );
+    pthread_mutex_init( &pool->lock, NULL );
+    pthread_cond_init( &pool->batchReady, NULL );
+    pthread_cond_init( &pool->batchDone, NULL );
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        pthread_mutex_init( &pool->ranges[i].lock, NULL );
+    }
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        WorkerStart *start = (WorkerStart*) malloc( sizeof( WorkerStart ) );
+        start->pool = pool;
+        start->worker = i;
+        pthread_create( &pool->threads[i], NULL, runWorker, start );
+    }
+
+    return pool;
+
+}
+
+/**
+ * @brief Stops the workers and destroys the ThreadPool.
+ */
+void destroyThreadPool( ThreadPool *pool ) {
+
+    pthread_mutex_lock( &pool->lock );
+    pool->stopping = true;
+    pthread_cond_broadcast( &pool->batchReady );
+    pthread_mutex_unlock( &pool->lock );
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        pthread_join( pool->threads[i], NULL );
+    }
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        pthread_mutex_destroy( &pool->ranges[i].lock );
+    }
+
+    pthread_cond_destroy( &pool->batchDone );
+    pthread_cond_destroy( &pool->batchReady );
+    pthread_mutex_destroy( &pool->lock );
+    free( pool->ranges );
+    free( pool->threads );
+    free( pool );
+
+}
+
+/**
+ * @brief Runs function for every job in [0, jobCount) on the workers and
+ * waits until all of them finish. Worker i starts with the i-th slice of
+ * the jobs and idle workers steal from busy ones, so uneven jobs are
+ * balanced while each worker mostly runs neighboring jobs. When pool is
+ * NULL the jobs run in order on the calling thread, as worker 0.
+ */
+void runThreadPool( ThreadPool *pool, int jobCount, JobFunction function, void *data ) {
+
+    if ( pool == NULL ) {
+        for ( int job = 0; job < jobCount; job++ ) {
+            function( data, job, 0 );
+        }
+        return;
+    }
+
+    pthread_mutex_lock( &pool->lock );
+
+    pool->function = function;
+    pool->data = data;
+
+    // workers are idle, so their ranges can be set without locking them
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        pool->ranges[i].next = (int) ( (long long) jobCount * i / pool->threadCount );
+        pool->ranges[i].end = (int) ( (long long) jobCount * ( i + 1 ) / pool->threadCount );
+    }
+
+    pool->activeWorkers = pool->threadCount;
+    pool->batch++;
+    pthread_cond_broadcast( &pool->batchReady );
+
+    while ( pool->activeWorkers > 0 ) {
+        pthread_cond_wait( &pool->batchDone, &pool->lock );
+    }
+
+    pthread_mutex_unlock( &pool->lock );
+
+}
+
+/**
+ * @brief Returns how many cores are available.
+ */
+int getCoreCount( void ) {
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    int count = (int) info.dwNumberOfProcessors;
+#else
+    int count = (int) sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+
+    return count > 0 ? count : 1;
+
+}
@@ -0,0 +1,39 @@
+/**
+ * @file Timer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Timer implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "Timer.h"
+
+/**
+ * @brief Returns the microseconds elapsed since an arbitrary point in the
+ * past. Never goes backwards.
+ */
+uint64_t getMicrosecondsTimer( void ) {
+
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &counter );
+    return (uint64_t) ( counter.QuadPart / frequency.QuadPart * 1000000 +
+                        counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart );
+#else
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t) now.tv_sec * 1000000 + (uint64_t) now.tv_nsec / 1000;
+#endif
+
+}
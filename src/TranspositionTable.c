@@ -0,0 +1,119 @@
+/**
+ * @file TranspositionTable.c
+ * @author Prof. Dr. David Buzatto
+ * @brief TranspositionTable implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "TranspositionTable.h"
+
+#define DEPTH_SHIFT 32
+#define MOVE_SHIFT 40
+#define DOWN_BIT ( 1ULL << 62 )
+#define USED_BIT ( 1ULL << 63 )
+
+static uint64_t packEntry( const TranspositionTable *table, float value, int depth, Move bestMove ) {
+
+    uint32_t valueBits;
+    memcpy( &valueBits, &value, sizeof( valueBits ) );
+
+    uint64_t cell = (uint64_t) ( bestMove.r1 * table->width + bestMove.c1 );
+
+    return valueBits |
+           (uint64_t) ( depth & 0xFF ) << DEPTH_SHIFT |
+           ( cell & 0x3FFFFF ) << MOVE_SHIFT |
+           ( bestMove.r2 != bestMove.r1 ? DOWN_BIT : 0 ) |
+           USED_BIT;
+
+}
+
+static void unpackEntry( const TranspositionTable *table, uint64_t data, TableProbe *probe ) {
+
+    uint32_t valueBits = (uint32_t) data;
+    int cell = (int) ( ( data >> MOVE_SHIFT ) & 0x3FFFFF );
+    int row = cell / table->width;
+    int col = cell % table->width;
+
+    memcpy( &probe->value, &valueBits, sizeof( valueBits ) );
+    probe->depth = (int) ( ( data >> DEPTH_SHIFT ) & 0xFF );
+    probe->bestMove = ( data & DOWN_BIT ) ? (Move) { row, col, row + 1, col } : (Move) { row, col, row, col + 1 };
+
+}
+
+/**
+ * @brief Creates a dinamically allocated table with 2^sizeBits entries
+ * (16 bytes each) for boards width cells wide.
+ */
+TranspositionTable* createTranspositionTable( int sizeBits, int width ) {
+
+    TranspositionTable *table = (TranspositionTable*) malloc( sizeof( TranspositionTable ) );
+
+    table->mask = ( 1ULL << sizeBits ) - 1;
+    table->width = width;
+    table->entries = (TableEntry*) calloc( (size_t) table->mask + 1, sizeof( TableEntry ) );
+
+    return table;
+
+}
+
+/**
+ * @brief Destroys a table.
+ */
+void destroyTranspositionTable( TranspositionTable *table ) {
+    free( table->entries );
+    free( table );
+}
+
+/**
+ * @brief Forgets every entry. Must not run while other threads use the
+ * table.
+ */
+void clearTranspositionTable( TranspositionTable *table ) {
+    memset( table->entries, 0, ( (size_t) table->mask + 1 ) * sizeof( TableEntry ) );
+}
+
+/**
+ * @brief Stores the value and best move of the board with the given hash,
+ * searched depth moves ahead. An entry of another board is always
+ * replaced; one of the same board only by a search at least as deep.
+ */
+void storeTranspositionTable( TranspositionTable *table, uint64_t hash, float value, int depth, Move bestMove ) {
+
+    TableEntry *entry = &table->entries[hash & table->mask];
+    uint64_t oldCheck = __atomic_load_n( &entry->check, __ATOMIC_RELAXED );
+    uint64_t oldData = __atomic_load_n( &entry->data, __ATOMIC_RELAXED );
+
+    if ( ( oldCheck ^ oldData ) == hash && (int) ( ( oldData >> DEPTH_SHIFT ) & 0xFF ) > depth ) {
+        return;
+    }
+
+    uint64_t data = packEntry( table, value, depth, bestMove );
+    __atomic_store_n( &entry->check, hash ^ data, __ATOMIC_RELAXED );
+    __atomic_store_n( &entry->data, data, __ATOMIC_RELAXED );
+
+}
+
+/**
+ * @brief Looks up the board with the given hash, filling probe and
+ * returning true when it is stored.
+ */
+bool probeTranspositionTable( const TranspositionTable *table, uint64_t hash, TableProbe *probe ) {
+
+    const TableEntry *entry = &table->entries[hash & table->mask];
+    uint64_t check = __atomic_load_n( &entry->check, __ATOMIC_RELAXED );
+    uint64_t data = __atomic_load_n( &entry->data, __ATOMIC_RELAXED );
+
+    if ( !( data & USED_BIT ) || ( check ^ data ) != hash ) {
+        return false;
+    }
+
+    unpackEntry( table, data, probe );
+
+    return true;
+
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Zobrist.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Zobrist implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdint.h>
+
+#include "Zobrist.h"
+
+/**
+ * @brief Returns the key of a piece of the given type at cell
+ * ( row * width + col ). Empty cells (PIECE_NULL) have key 0. Keys are
+ * computed by a fixed mixing function, so they are the same in every
+ * thread and every run and need no table.
+ */
+uint64_t keyZobrist( int cell, PieceType type ) {
+
+    if ( type == PIECE_NULL ) {
+        return 0;
+    }
+
+    // splitmix64 finalizer of the ( cell, type ) index
+    uint64_t z = ( (uint64_t) cell * PIECE_TYPE_COUNT + type + 1 ) * 0x9E3779B97F4A7C15ULL;
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+
+    return z ^ ( z >> 31 );
+
+}
+
+/**
+ * @brief Returns the hash of every cell of the board.
+ */
+uint64_t hashBoardZobrist( const Board *board ) {
+
+    uint64_t hash = 0;
+    int count = board->width * board->height;
+
+    for ( int i = 0; i < count; i++ ) {
+        hash ^= keyZobrist( i, board->cells[i] );
+    }
+
+    return hash;
+
+}
+
+/**
+ * @brief Returns what must be XORed to the hash of the board when the two
+ * pieces of the move are swapped (the same value before and after the
+ * swap).
+ */
+uint64_t swapZobrist( const Board *board, Move move ) {
+
+    int a = move.r1 * board->width + move.c1;
+    int b = move.r2 * board->width + move.c2;
+    PieceType ta = board->cells[a];
+    PieceType tb = board->cells[b];
+
+    return keyZobrist( a, ta ) ^ keyZobrist( b, ta ) ^ keyZobrist( a, tb ) ^ keyZobrist( b, tb );
+
+}
+
+/**
+ * @brief Returns what must be XORed to a hash when a piece of the given
+ * type moves from cell from to cell to (e.g. when it falls).
+ */
+uint64_t moveZobrist( int from, int to, PieceType type ) {
+    return keyZobrist( from, type ) ^ keyZobrist( to, type );
+}
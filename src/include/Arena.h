@@ -0,0 +1,114 @@
+/**
+ * @file Arena.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Arena and ArenaList structs and function declarations. An arena
+ * hands out memory from large blocks and takes it all back at once, so
+ * lists and scratch arrays that live for a frame (or a cascade step) grow
+ * as needed without allocating each element, and once the arena has seen
+ * its largest frame they are not allocated at all.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+} ArenaBlock;
+
+/**
+ * @brief Memory handed out from a list of blocks, from the first up to
+ * current. used is what was handed out since the last reset, highWater
+ * the most that ever was and capacity the size of all the blocks.
+ */
+typedef struct Arena {
+    ArenaBlock *first;
+    ArenaBlock *current;
+    uint8_t *next;
+    uint8_t *end;
+    size_t blockSize;
+    size_t used;
+    size_t highWater;
+    size_t capacity;
+} Arena;
+
+/**
+ * @brief How far an arena was used at some point, to give back what was
+ * handed out after it.
+ */
+typedef struct ArenaMark {
+    ArenaBlock *block;
+    uint8_t *next;
+    size_t used;
+} ArenaMark;
+
+/**
+ * @brief A growable array of itemSize bytes items kept in an arena. When
+ * it is full the items move to a region twice as large and the old one
+ * is only reclaimed by the next reset of the arena, which must happen
+ * together with clearArenaList.
+ */
+typedef struct ArenaList {
+    Arena *arena;
+    void *items;
+    int count;
+    int capacity;
+    size_t itemSize;
+} ArenaList;
+
+/**
+ * @brief Creates a dinamically allocated empty arena that grows in
+ * blocks of at least blockSize bytes.
+ */
+Arena* createArena( size_t blockSize );
+
+/**
+ * @brief Destroys an arena and every block it holds.
+ */
+void destroyArena( Arena *arena );
+
+/**
+ * @brief Returns size bytes of the arena, aligned for any type. The
+ * memory is valid up to the next resetArena.
+ */
+void *allocArena( Arena *arena, size_t size );
+
+/**
+ * @brief Takes back everything handed out by the arena. The blocks are
+ * kept; if the arena had to grow, they are merged into a single block
+ * of its whole capacity first, so the next frames fit in one block.
+ */
+void resetArena( Arena *arena );
+
+/**
+ * @brief Returns a mark of how far the arena is used now.
+ */
+ArenaMark markArena( const Arena *arena );
+
+/**
+ * @brief Takes back what the arena handed out after mark was taken,
+ * keeping its blocks for the next allocations. Scratch arrays that are
+ * only needed during a call are given back this way, so a frame arena
+ * does not grow with the number of calls.
+ */
+void rewindArena( Arena *arena, ArenaMark mark );
+
+/**
+ * @brief Initializes an empty list of itemSize bytes items in arena.
+ */
+void initArenaList( ArenaList *list, Arena *arena, size_t itemSize );
+
+/**
+ * @brief Appends an item to the list, growing it if needed, and returns
+ * where the item must be written.
+ */
+void *pushArenaList( ArenaList *list );
+
+/**
+ * @brief Empties the list. Its memory goes back to the arena with the
+ * next resetArena.
+ */
+void clearArenaList( ArenaList *list );
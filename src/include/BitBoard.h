@@ -0,0 +1,91 @@
+/**
+ * @file BitBoard.h
+ * @author Prof. Dr. David Buzatto
+ * @brief BitBoard struct and function declarations. A bitboard stores one
+ * 64 bit mask per piece type, where bit ( row * 8 + col ) is set when the
+ * cell at ( row, col ) holds a piece of that type.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+
+#define BITBOARD_SIZE 8
+#define BITBOARD_CELLS ( BITBOARD_SIZE * BITBOARD_SIZE )
+
+typedef struct BitBoard {
+    uint64_t pieces[PIECE_TYPE_COUNT];
+} BitBoard;
+
+/**
+ * @brief The legal swaps of a board. Bit ( row * 8 + col ) of right is set
+ * when swapping ( row, col ) with ( row, col + 1 ) makes a match and the
+ * same bit of down when swapping ( row, col ) with ( row + 1, col ) does.
+ */
+typedef struct MoveSet {
+    uint64_t right;
+    uint64_t down;
+} MoveSet;
+
+/**
+ * @brief Returns the bit that represents the cell at ( row, col ).
+ */
+uint64_t cellBitBoard( int row, int col );
+
+/**
+ * @brief Removes every piece from the bitboard.
+ */
+void clearBitBoard( BitBoard *bb );
+
+/**
+ * @brief Stores a piece of the given type at ( row, col ).
+ */
+void setBitBoard( BitBoard *bb, int row, int col, PieceType type );
+
+/**
+ * @brief Loads every cell of a board (of at most BITBOARD_SIZE x
+ * BITBOARD_SIZE cells) into the bitboard.
+ */
+void loadBitBoard( BitBoard *bb, const Board *board );
+
+/**
+ * @brief Returns the cells of a single piece type mask that belong to a
+ * horizontal or vertical run of three or more pieces.
+ */
+uint64_t findMatchesBitBoard( uint64_t pieces );
+
+/**
+ * @brief Returns the cells, of any piece type, that belong to a horizontal
+ * or vertical run of three or more pieces.
+ */
+uint64_t findAllMatchesBitBoard( const BitBoard *bb );
+
+/**
+ * @brief Finds every swap of a stable board that makes a match, using the
+ * "two in line plus a gap" and "two in line plus a neighbor" patterns of
+ * each piece type.
+ */
+void findMovesBitBoard( const BitBoard *bb, MoveSet *moves );
+
+/**
+ * @brief Refreshes a move set after the cells in changed were modified.
+ * Only swaps close enough to a changed cell to be affected are
+ * recomputed, and only for the piece types present around them; the rest
+ * of the set is kept.
+ */
+void updateMovesBitBoard( const BitBoard *bb, MoveSet *moves, uint64_t changed );
+
+/**
+ * @brief Returns how many swaps the move set holds.
+ */
+int countMovesBitBoard( const MoveSet *moves );
+
+/**
+ * @brief Copies up to capacity swaps of the move set to list, in row-major
+ * order of their first cell. Returns how many were copied.
+ */
+int listMovesBitBoard( const MoveSet *moves, Move *list, int capacity );
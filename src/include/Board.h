@@ -0,0 +1,112 @@
+/**
+ * @file Board.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Board struct and function declarations. A board is the logical
+ * state of the grid: only the piece type of each cell, stored row by row,
+ * without any rendering data.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "ThreadPool.h"
+
+#define BOARD_MAX_SIZE 1024
+
+/**
+ * @brief A board of any size, up to BOARD_MAX_SIZE x BOARD_MAX_SIZE cells.
+ * cells points to width * height bytes that the board does not own: they
+ * come from createBoard or, for the small boards the search engines copy
+ * around, from a buffer given to initBoard. Assigning a board to another
+ * shares the cells, so copyBoard must be used to copy them.
+ */
+typedef struct Board {
+    int width;
+    int height;
+    uint8_t *cells;
+} Board;
+
+/**
+ * @brief The result of letting the pieces of a board fall. fall[row * width + col]
+ * is how many cells the piece that ended at ( row, col ) fell and
+ * newPieces[col] is how many empty cells were left at the top of each
+ * column (their pieces, once refilled, fall newPieces[col] cells). Like
+ * the cells of a board, both arrays are given by the owner of the struct.
+ */
+typedef struct Gravity {
+    int *fall;
+    int *newPieces;
+} Gravity;
+
+/**
+ * @brief Returns true if a board of width x height cells is supported.
+ */
+bool isValidSizeBoard( int width, int height );
+
+/**
+ * @brief Initializes an empty board (all cells with PIECE_NULL) over
+ * cells, which must hold width * height bytes.
+ */
+void initBoard( Board *board, int width, int height, uint8_t *cells );
+
+/**
+ * @brief Creates a dinamically allocated empty board, with its cells.
+ * Returns NULL if the size is not supported.
+ */
+Board* createBoard( int width, int height );
+
+/**
+ * @brief Destroys a board created with createBoard.
+ */
+void destroyBoard( Board *board );
+
+/**
+ * @brief Copies the size and the cells of src to dst, whose cells must
+ * have room for them.
+ */
+void copyBoard( Board *dst, const Board *src );
+
+/**
+ * @brief Returns true if both boards have the same size and cells.
+ */
+bool equalsBoard( const Board *a, const Board *b );
+
+/**
+ * @brief Returns the piece type at ( row, col ).
+ */
+PieceType getPieceBoard( const Board *board, int row, int col );
+
+/**
+ * @brief Stores a piece type at ( row, col ).
+ */
+void setPieceBoard( Board *board, int row, int col, PieceType type );
+
+/**
+ * @brief Creates a dinamically allocated gravity result with room for a
+ * board of width x height cells.
+ */
+Gravity* createGravity( int width, int height );
+
+/**
+ * @brief Destroys a gravity result created with createGravity.
+ */
+void destroyGravity( Gravity *gravity );
+
+/**
+ * @brief Lets every piece fall over the empty cells below it, compacting
+ * each column in a single bottom-up pass with a write cursor. The empty
+ * cells end at the top of each column. Fall distances and new piece
+ * counts are stored in gravity.
+ */
+void applyGravityBoard( Board *board, Gravity *gravity );
+
+/**
+ * @brief Same as applyGravityBoard, with the columns split into bands
+ * that fall in parallel on pool (on the calling thread when pool is
+ * NULL). Columns never interact, so the result is the same.
+ */
+void applyGravityTiledBoard( ThreadPool *pool, Board *board, Gravity *gravity );
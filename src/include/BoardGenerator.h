@@ -0,0 +1,53 @@
+/**
+ * @file BoardGenerator.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Board generation function declarations. Boards are built
+ * constructively, in a single pass, so they never start with matches and
+ * always have at least one legal move.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Board.h"
+#include "Rng.h"
+
+// larger boards are reshuffled one region of this many cells per side at
+// a time
+#define RESHUFFLE_REGION_SIZE 128
+
+/**
+ * @brief Fills the board (with its width and height already set) with
+ * random pieces. A random legal move is planted first and then each cell
+ * takes a random type among the ones that do not complete a run with the
+ * cells already filled, so no rejection loop is needed. Boards smaller
+ * than 3 x 2 cells cannot hold a move and only get the no-match guarantee.
+ */
+void generateBoard( Board *board, Rng *rng );
+
+/**
+ * @brief Rearranges the pieces of the board keeping how many pieces of
+ * each type there are (empty cells stay where they are). The result has
+ * no matches and at least one legal move. Like generateBoard it plants a
+ * move and fills the other cells in one pass, each drawing a random piece
+ * among the ones left that do not make a run there; when none fits, an
+ * earlier cell, near or random, is exchanged with it. Boards larger than
+ * RESHUFFLE_REGION_SIZE on a side only have a random region of that size
+ * rearranged, without runs with the pieces around it, so a reshuffle
+ * takes the same time on any board, well within a frame (tools/tiles.c
+ * times it on large boards). Returns false, leaving the board unchanged,
+ * when no arrangement could be built (e.g. no type has three pieces).
+ */
+bool reshuffleBoard( Board *board, Rng *rng );
+
+/**
+ * @brief Makes sure a board has at least one legal move: when it has none
+ * the board is reshuffled (a few times if needed, on large boards each
+ * time in another region) or, as a last resort, three pieces of a type
+ * are exchanged into a move where they make no run. The counts of each
+ * type are always kept. Returns true if the board was changed; false
+ * when it already has a move or no move could be made with its pieces.
+ */
+bool ensureMovesBoard( Board *board, Rng *rng );
@@ -0,0 +1,54 @@
+/**
+ * @file Canonical.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Canonical form of boards. The piece colors are interchangeable for
+ * the rules and a board matches and falls the same as its mirror images,
+ * so every board of an equivalence class is mapped to one representative,
+ * used as the key of analysis caches. Refills are drawn by cell and color,
+ * so equivalent boards only share what does not depend on the drawn
+ * pieces (or its expectation over them).
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+
+/**
+ * @brief Mirror bits. MIRROR_COLUMNS swaps left and right and keeps the
+ * matches and gravity. MIRROR_ROWS swaps top and bottom,
+ * which keeps the matches of a board but not its cascades.
+ */
+#define MIRROR_COLUMNS 1
+#define MIRROR_ROWS 2
+
+/**
+ * @brief Stores in canonical the canonical form of board: for each valid
+ * mirror the cells are read in row-major order of the mirrored board and
+ * the colors are relabelled 1, 2, ... in order of first appearance (empty
+ * cells stay empty); the lexicographically smallest result is kept. With
+ * keepGravity only the column mirror is valid, otherwise the row mirror
+ * and both are too. Returns the mirror of the result (0 for none); when
+ * colors is not NULL, colors[label] receives the original type of each
+ * label. Candidates are compared while they are built and dropped at the
+ * first larger cell, so most mirrors cost only a few cells. The cells of
+ * canonical must have room for the cells of board.
+ */
+int canonicalizeBoard( const Board *board, bool keepGravity, Board *canonical, uint8_t *colors );
+
+/**
+ * @brief Returns the Zobrist hash of the canonical form of board, equal
+ * for every equivalent board.
+ */
+uint64_t hashCanonical( const Board *board, bool keepGravity );
+
+/**
+ * @brief Maps a move between a board and its mirror (mirrors are their
+ * own inverse, so the same call maps both ways). The result keeps the
+ * convention of the first cell being the left or upper one.
+ */
+Move mirrorMoveCanonical( Move move, int mirror, int width, int height );
@@ -0,0 +1,108 @@
+/**
+ * @file Cascade.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Cascade struct and function declarations. Resolves swaps on a
+ * logical board until it is stable (remove, fall, refill and match again),
+ * without any animation or rendering.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "Match.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include "Arena.h"
+
+#define CASCADE_STEP_CAPACITY 32
+#define CASCADE_GROUP_CAPACITY 128
+#define CASCADE_CELL_CAPACITY 512
+
+typedef struct CascadeStep {
+    int firstGroup;
+    int groupCount;
+    int clearedCells;
+} CascadeStep;
+
+/**
+ * @brief The outcome of a resolution. Each step is one remove, fall and
+ * refill round; its groups are groups[steps[s].firstGroup] onwards and
+ * the cells of each group are stored in cells. Only the first
+ * CASCADE_STEP_CAPACITY steps (and the groups and cells that fit) are
+ * recorded, but depth, clearedCells and shapes count every step.
+ * hashDelta is the XOR of the Zobrist keys changed by the swap, removals,
+ * falls and refills: the hash of the resulting board is the hash of the
+ * initial one XOR hashDelta.
+ */
+typedef struct Cascade {
+    int depth;
+    uint64_t hashDelta;
+    int clearedCells;
+    int shapes[MATCH_SHAPE_CROSS + 1];
+    CascadeStep steps[CASCADE_STEP_CAPACITY];
+    int stepCount;
+    MatchGroup groups[CASCADE_GROUP_CAPACITY];
+    int groupCount;
+    Position cells[CASCADE_CELL_CAPACITY];
+    int cellCount;
+} Cascade;
+
+/**
+ * @brief Returns true if the two cells of the move are inside the board,
+ * are neighbors and hold different pieces.
+ */
+bool isSwapAllowed( const Board *board, Move move );
+
+/**
+ * @brief Returns true if the swap is allowed and makes a match. Only the
+ * lines through the two cells are looked at, so it works on boards of any
+ * size (small boards can use a bitboard move set instead).
+ */
+bool isMatchingSwapBoard( const Board *board, Move move );
+
+/**
+ * @brief Lists the swaps of the board that make a match, in row-major
+ * order of their first cell (the right swap before the down one), in
+ * moves. The scan stops once capacity swaps were found, so asking for a
+ * single one is enough to know if a large board has any. Returns how many
+ * were stored.
+ */
+int findMovesBoard( const Board *board, Move *moves, int capacity );
+
+/**
+ * @brief Removes every match of the board, lets the pieces fall and
+ * refills the empty cells, repeating until no match remains. New pieces
+ * are drawn from rng column by column, from top to bottom; when rng is
+ * NULL the empty cells are kept empty. Returns the cascade depth.
+ */
+int resolveBoard( Board *board, Rng *rng, Cascade *cascade );
+
+/**
+ * @brief Same as resolveBoard, with the match scan, the fall of the
+ * pieces and its hashing split into bands of rows and columns that run in
+ * parallel on pool (on the calling thread when pool is NULL). The result,
+ * including the refills drawn from rng, is the same. Boards larger than a
+ * bitboard take their scratch arrays from scratch, given back before
+ * returning, or allocate them when it is NULL.
+ */
+int resolveTiledBoard( ThreadPool *pool, Arena *scratch, Board *board, Rng *rng, Cascade *cascade );
+
+/**
+ * @brief Swaps the two pieces of the move and resolves the board until it
+ * is stable. If the swap is not allowed or does not make a match, the
+ * board is left unchanged and false is returned.
+ */
+bool resolveSwapBoard( Board *board, Move move, Rng *rng, Cascade *cascade );
+
+/**
+ * @brief Same as resolveSwapBoard, for callers that only need the totals
+ * of the cascade: on boards that fit a bitboard only its depth and cleared
+ * cells are stored (no steps, shapes or hash delta), skipping the match
+ * groups and the hashing of resolveBoard. The board and the pieces drawn
+ * from rng are the same. Larger boards are resolved by resolveSwapBoard.
+ */
+bool resolveSwapTotalsBoard( Board *board, Move move, Rng *rng, Cascade *cascade );
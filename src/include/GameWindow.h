@@ -16,6 +16,8 @@ typedef struct GameWindow {
     int width;
     int height;
     const char *title;
+    int boardWidth;
+    int boardHeight;
 
     int targetFPS;
     bool antialiasing;
@@ -41,6 +43,8 @@ GameWindow* createGameWindow(
         int width, 
         int height, 
         const char *title, 
+        int boardWidth,
+        int boardHeight,
         int targetFPS,
         bool antialiasing, 
         bool resizable, 
@@ -9,23 +9,127 @@
 
 #include "raylib/raylib.h"
 #include "Types.h"
+#include "Board.h"
+#include "Rng.h"
+#include "Replay.h"
+#include "BitBoard.h"
+#include "Match.h"
+#include "Search.h"
+#include "Puzzle.h"
+#include "ThreadPool.h"
+#include "Arena.h"
 
-#define GRID_WIDTH 8
-#define GRID_HEIGHT 8
+#define GAME_MIN_SIZE 5
+#define GAME_DEFAULT_SIZE 8
+#define GAME_TILED_CELLS ( 128 * 128 )
+#define GAME_STEPS_PER_SECOND 120
+
+/**
+ * @brief A swap of the selected piece with one of its neighbors, resolved
+ * while the player is still dragging. valid tells if it makes a match;
+ * for valid swaps matchList holds the first matches and settled the board
+ * the whole cascade ends on (only on boards the hint search reaches, which
+ * have it allocated).
+ */
+typedef struct SwapSpeculation {
+    Move move;
+    bool resolved;
+    bool valid;
+    MatchList *matchList;
+    Board *settled;
+} SwapSpeculation;
 
 typedef struct GameWorld {
     Color background;
     Color detail;
-    Piece grid[GRID_WIDTH][GRID_HEIGHT];
+
+    // the grid has width x height cells, stored row by row; regular games
+    // are gameWidth x gameHeight, puzzles PUZZLE_SIZE x PUZZLE_SIZE. board
+    // holds the piece type of every cell, one byte each, and is what the
+    // engine works on. The render state of the pieces is kept apart, in
+    // arrays parallel to the cells: how far each piece is drawn from its
+    // cell while it is dragged or falls, where each falling piece was one
+    // step before (drawn in between) and its PIECE_FLAG_* flags
+    int width;
+    int height;
+    int gameWidth;
+    int gameHeight;
+    Board *board;
+    Vector2 *pieceOffsets;
+    float *lastFallOffsets;
+    uint8_t *pieceFlags;
+    Gravity *gravity;
+
+    // boards of GAME_TILED_CELLS cells or more find their matches and let
+    // their pieces fall in bands of rows and columns spread over pool
+    ThreadPool *pool;
+
+    // boards larger than the window are drawn at pieceSize (never smaller
+    // than MIN_PIECE_SIZE) and scrolled with the camera
     int pieceSize;
     int pieceMargin;
+    Camera2D camera;
     GameState state;
+    uint64_t seed;
+    Rng rng;
+    uint32_t frame;
+    Replay *replay;
+
+    // puzzle mode: built-in puzzle index (-1 for a regular game), its goal,
+    // the solve of the current board (stepped every frame; its solution is
+    // followed swap by swap, solved again when the player leaves it) and
+    // the table every solve shares
+    int puzzleIndex;
+    const char *puzzleName;
+    PuzzleGoal puzzleGoal;
+    AnytimePuzzle puzzleSolve;
+    TranspositionTable *puzzleTable;
+
+    // interaction: the cells of the dragged piece and of its neighbors,
+    // -1 when there is none
+    int selectedRow;
+    int selectedCol;
+    int selectedCell;
+    Vector2 pressPos;
+    Vector2 mousePos;
+    int leftNeighbor;
+    int rightNeighbor;
+    int topNeighbor;
+    int downNeighbor;
+    int beingSwapped;
+    SwapSpeculation speculations[4];
+    int speculationCount;
+
+    // matches, legal moves and the cells whose pieces are falling; the
+    // move set and the changed cells are only kept for boards that fit a
+    // bitboard
+    MatchList *matchList;
+    MoveSet moveSet;
+    bool hasMoves;
+    Move firstMove;
+    uint64_t changedCells;
+    bool showHint;
+    AnytimeSearch hintSearch;
+    TranspositionTable *searchTable;
+    uint64_t hintBudget;
+    bool showBestHint;
+    ArenaList animationList;
+
+    // the falling cells are kept until their fall ends; the match scans
+    // and cascades of large boards borrow their scratch arrays from the
+    // frame arena
+    Arena *animationArena;
+    Arena *frameArena;
+    float fallSpeed;
+    float stepAlpha;
 } GameWorld;
 
 /**
- * @brief Creates a dinamically allocated GameWorld struct instance.
+ * @brief Creates a dinamically allocated GameWorld struct instance, with
+ * regular games played on boards of width x height pieces (clamped from
+ * GAME_MIN_SIZE up to BOARD_MAX_SIZE).
  */
-GameWorld* createGameWorld( void );
+GameWorld* createGameWorld( int width, int height );
 
 /**
  * @brief Destroys a GameWindow object and its dependecies.
@@ -33,11 +137,21 @@ GameWorld* createGameWorld( void );
 void destroyGameWorld( GameWorld *gw );
 
 /**
- * @brief Reads user input and updates the state of the game.
+ * @brief Reads user input and updates the state of the game, once per
+ * rendered frame of delta seconds.
  */
 void updateGameWorld( GameWorld *gw, float delta );
 
 /**
- * @brief Draws the state of the game.
+ * @brief Advances the falling pieces by one simulation step of step
+ * seconds. Called at a fixed rate (GAME_STEPS_PER_SECOND), whatever the
+ * frame rate is, the falls take the same steps on every machine.
+ */
+void stepGameWorld( GameWorld *gw, float step );
+
+/**
+ * @brief Draws the state of the game, with the falling pieces alpha
+ * (from 0 to 1) of the way from where they were at the step before the
+ * last one to where they are now.
  */
-void drawGameWorld( GameWorld *gw );
\ No newline at end of file
+void drawGameWorld( GameWorld *gw, float alpha );
\ No newline at end of file
@@ -0,0 +1,90 @@
+/**
+ * @file Match.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Match structs and function declarations. A match group is a set
+ * of cells of the same piece type made of one or more horizontal and
+ * vertical runs of three or more pieces that share cells.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include "Types.h"
+#include "Board.h"
+#include "ThreadPool.h"
+#include "Arena.h"
+
+#define MATCH_GROUP_CAPACITY( cells ) ( ( cells ) / 3 + 1 )
+
+typedef enum MatchShape {
+    MATCH_SHAPE_LINE_3,
+    MATCH_SHAPE_LINE_4,
+    MATCH_SHAPE_LINE_5,
+    MATCH_SHAPE_L,
+    MATCH_SHAPE_T,
+    MATCH_SHAPE_CROSS
+} MatchShape;
+
+typedef struct MatchGroup {
+    PieceType type;
+    MatchShape shape;
+    int firstCell;
+    int cellCount;
+} MatchGroup;
+
+/**
+ * @brief The groups found in a board. The cells of group g are
+ * cells[groups[g].firstCell] up to cells[groups[g].firstCell + groups[g].cellCount - 1].
+ * cells has room for capacity cells, which must be at least the number of
+ * cells of the boards the list is used with, and groups for
+ * MATCH_GROUP_CAPACITY( capacity ) groups (every group has three cells or
+ * more). Like the cells of a board, both are given by the owner of the
+ * list. When scratch is not NULL, scans of large boards take their
+ * scratch arrays from it instead of allocating them and give them back
+ * before returning; lists sharing it must not scan at the same time.
+ */
+typedef struct MatchList {
+    MatchGroup *groups;
+    int groupCount;
+    Position *cells;
+    int cellCount;
+    int capacity;
+    Arena *scratch;
+} MatchList;
+
+/**
+ * @brief Initializes an empty match list over groups and cells, with
+ * room for the groups of a board of capacity cells.
+ */
+void initMatchList( MatchList *list, int capacity, MatchGroup *groups, Position *cells );
+
+/**
+ * @brief Creates a dinamically allocated empty match list, with room for
+ * the groups of a board of capacity cells.
+ */
+MatchList* createMatchList( int capacity );
+
+/**
+ * @brief Destroys a match list created with createMatchList.
+ */
+void destroyMatchList( MatchList *list );
+
+/**
+ * @brief Scans the whole board once, with a row and a column run-length
+ * pass, and stores every match group found in list. The board is not
+ * changed. Groups with crossing runs are classified as cross (both runs
+ * crossed in their interior), T (one run touched by the end of the other)
+ * or L (runs sharing an end); groups of a single run are classified by its
+ * length. The capacity of list must be at least the number of cells of
+ * the board. Returns the number of groups found.
+ */
+int findMatchGroups( const Board *board, MatchList *list );
+
+/**
+ * @brief Same as findMatchGroups, with the row pass split into bands of
+ * rows and the column pass into bands of columns that run in parallel on
+ * pool (on the calling thread when pool is NULL). Runs crossing the
+ * borders of the bands are joined afterwards, so the groups, their order
+ * and their cells are exactly the ones findMatchGroups finds.
+ */
+int findMatchGroupsTiled( ThreadPool *pool, const Board *board, MatchList *list );
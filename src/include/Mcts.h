@@ -0,0 +1,106 @@
+/**
+ * @file Mcts.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Mcts struct and function declarations. Root-parallel Monte Carlo
+ * tree search: several independent trees are grown from the same board,
+ * each with its own random stream, and their root statistics are summed
+ * to choose the move.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "BitBoard.h"
+#include "Cascade.h"
+#include "ThreadPool.h"
+
+#define MCTS_MAX_DEPTH 64
+#define MCTS_ROOT_MOVES ( 2 * BITBOARD_CELLS )
+
+/**
+ * @brief playouts is the total over every tree. horizon is how many moves
+ * a playout lasts, counting the ones made inside the tree, so every
+ * playout scores the cells cleared over the same number of moves.
+ * exploration is the UCB1 constant, in cells.
+ */
+typedef struct MctsConfig {
+    int playouts;
+    int trees;
+    int horizon;
+    float exploration;
+    uint64_t seed;
+} MctsConfig;
+
+/**
+ * @brief A node of a tree, reached by playing move from its parent. Refills
+ * are random, so the tree is open loop: a node stands for the move
+ * sequence, the board is simulated again in every playout and only the
+ * children whose move is legal on that board are considered. expanded
+ * marks, with the MoveSet layout, which moves already have a child.
+ */
+typedef struct MctsNode {
+    Move move;
+    int visits;
+    float totalScore;
+    int firstChild;
+    int nextSibling;
+    MoveSet expanded;
+} MctsNode;
+
+typedef struct MctsResult {
+    bool found;
+    Move move;
+    float expectedScore;
+    long long visits;
+    long long playouts;
+    double seconds;
+    double playoutsPerSecond;
+} MctsResult;
+
+/**
+ * @brief Scratch memory of one worker: the node pool of the tree being
+ * grown and a cascade for the resolver.
+ */
+typedef struct MctsWorker {
+    MctsNode *nodes;
+    int nodeCapacity;
+    int nodeCount;
+    Cascade cascade;
+} MctsWorker;
+
+typedef struct Mcts {
+    MctsConfig config;
+    int workerCount;
+    MctsWorker *workers;
+    int *rootVisits;
+    float *rootScores;
+    const Board *board;
+} Mcts;
+
+/**
+ * @brief Creates a dinamically allocated Mcts able to run on workerCount
+ * threads, with every node pool allocated up front.
+ */
+Mcts* createMcts( MctsConfig config, int workerCount );
+
+/**
+ * @brief Destroys a Mcts and its node pools.
+ */
+void destroyMcts( Mcts *mcts );
+
+/**
+ * @brief Grows config.trees trees from a stable board (of at most 8 x 8
+ * cells) and stores the most visited root move in result, along with the
+ * playout throughput. Trees are jobs of pool, which must have at most the
+ * workerCount threads given to createMcts; when pool is NULL they are
+ * grown on the calling thread. Tree t always uses random stream t + 1, so
+ * the result only depends on the configuration, not on the scheduling.
+ * Returns false when the board has no legal move or is larger than 8 x 8
+ * cells.
+ */
+bool findBestMoveMcts( Mcts *mcts, ThreadPool *pool, const Board *board, MctsResult *result );
@@ -0,0 +1,103 @@
+/**
+ * @file PackedBoard.h
+ * @author Prof. Dr. David Buzatto
+ * @brief PackedBoard struct and function declarations. Piece types need
+ * three bits (seven colors plus empty), so a board of up to
+ * BITBOARD_SIZE x BITBOARD_SIZE cells packs in 192 bits, a third of its
+ * byte cells. Packed boards are cheap to keep by the thousands (undo
+ * snapshots, search nodes) and copied or compared a few words at a time.
+ * Boards of any size are encoded as byte streams of three bits per cell
+ * (replay keyframes, network messages).
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "BitBoard.h"
+
+#define PACKED_BOARD_PLANES 3
+
+// width and height (16 bits each, little endian) before the cells
+#define PACKED_BOARD_HEADER_SIZE 4
+
+/**
+ * @brief A board of up to BITBOARD_SIZE x BITBOARD_SIZE cells as three bit
+ * planes with the bitboard layout: bit k of the type of cell ( row, col )
+ * is bit row * BITBOARD_SIZE + col of planes[k]. Bits outside the board
+ * are zero, so two packed boards are equal exactly when their planes and
+ * sizes are.
+ */
+typedef struct PackedBoard {
+    uint64_t planes[PACKED_BOARD_PLANES];
+    uint8_t width;
+    uint8_t height;
+} PackedBoard;
+
+/**
+ * @brief Packs board, which must fit in BITBOARD_SIZE x BITBOARD_SIZE
+ * cells, into packed.
+ */
+void loadPackedBoard( PackedBoard *packed, const Board *board );
+
+/**
+ * @brief Unpacks packed into board, whose cells must have room for the
+ * packed board.
+ */
+void storePackedBoard( const PackedBoard *packed, Board *board );
+
+/**
+ * @brief Fills bb with the piece masks of packed, straight from its
+ * planes.
+ */
+void toBitBoardPackedBoard( const PackedBoard *packed, BitBoard *bb );
+
+/**
+ * @brief Returns true if both packed boards have the same size and cells.
+ */
+bool equalsPackedBoard( const PackedBoard *a, const PackedBoard *b );
+
+/**
+ * @brief Returns a 64-bit hash of the size and cells of packed. Unlike
+ * hashBoardZobrist it can not be updated move by move, but it costs a
+ * few multiplications.
+ */
+uint64_t hashPackedBoard( const PackedBoard *packed );
+
+/**
+ * @brief Copies count packed boards from src to dst (which must not
+ * overlap).
+ */
+void copyPackedBoards( PackedBoard *dst, const PackedBoard *src, int count );
+
+/**
+ * @brief Returns the index of the first of the count packed boards equal
+ * to key, or -1 if there is none.
+ */
+int findPackedBoard( const PackedBoard *boards, int count, const PackedBoard *key );
+
+/**
+ * @brief Returns how many bytes encodePackedBoard writes for a board of
+ * width x height cells.
+ */
+size_t getEncodedSizePackedBoard( int width, int height );
+
+/**
+ * @brief Encodes board, of any size, in out: the header followed by the
+ * cells in row-major order, three bits each, from the lowest bit of each
+ * byte up. out must have room for getEncodedSizePackedBoard bytes.
+ * Returns how many bytes were written.
+ */
+size_t encodePackedBoard( const Board *board, uint8_t *out );
+
+/**
+ * @brief Decodes a board encoded by encodePackedBoard from the size bytes
+ * of in. The cells of board must have room for the encoded board. Returns
+ * false, leaving board unchanged, if the bytes are not a valid encoding.
+ */
+bool decodePackedBoard( const uint8_t *in, size_t size, Board *board );
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdint.h>
+
+#include "raylib/raylib.h"
 #include "Types.h"
 
-void drawPiece( Piece *p, int padding );
\ No newline at end of file
+void drawPiece( PieceType type, Vector2 pos, float size, uint8_t flags, int padding );
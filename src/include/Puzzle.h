@@ -0,0 +1,127 @@
+/**
+ * @file Puzzle.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Puzzle struct and function declarations. In puzzle mode removed
+ * pieces are not refilled, so a board is a closed problem: reach a goal
+ * (empty the board or clear every piece of a color) with as few swaps as
+ * possible.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "BitBoard.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+
+#define PUZZLE_SIZE BITBOARD_SIZE
+#define PUZZLE_MAX_DEPTH 16
+#define PUZZLE_BUILTIN_COUNT 4
+#define PUZZLE_TABLE_BITS 20
+
+typedef enum PuzzleGoalType {
+    PUZZLE_GOAL_EMPTY_BOARD,
+    PUZZLE_GOAL_CLEAR_COLOR
+} PuzzleGoalType;
+
+typedef struct PuzzleGoal {
+    PuzzleGoalType type;
+    PieceType color;
+} PuzzleGoal;
+
+/**
+ * @brief The outcome of a solve. When solved, moves holds a shortest
+ * sequence of moveCount swaps. When not, unsolvable tells whether every
+ * sequence was tried (no solution exists at all) or the search stopped at
+ * the depth limit.
+ */
+typedef struct PuzzleSolution {
+    bool solved;
+    bool unsolvable;
+    int moveCount;
+    Move moves[PUZZLE_MAX_DEPTH];
+    long long nodes;
+    uint64_t microseconds;
+} PuzzleSolution;
+
+/**
+ * @brief Resumable solve for the game loop, so a frame never waits for a
+ * whole solve. It searches its own copy of the board, sharing table with
+ * the other solves; solution is only final once finished.
+ */
+typedef struct AnytimePuzzle {
+    uint8_t cells[PUZZLE_SIZE * PUZZLE_SIZE];
+    Board board;
+    PuzzleGoal goal;
+    int maxDepth;
+    int depth;
+    TranspositionTable *table;
+    PuzzleSolution solution;
+    bool finished;
+} AnytimePuzzle;
+
+/**
+ * @brief Loads one of the built-in puzzles (0 up to PUZZLE_BUILTIN_COUNT -
+ * 1), already stable, with its goal. Every built-in puzzle has
+ * PUZZLE_SIZE x PUZZLE_SIZE cells, which the cells of board must have room
+ * for. Returns its name, or NULL if there is no such puzzle.
+ */
+const char *loadBuiltinPuzzle( int index, Board *board, PuzzleGoal *goal );
+
+/**
+ * @brief Removes the matches a puzzle starts with, without refilling.
+ */
+void stabilizePuzzle( Board *board );
+
+/**
+ * @brief Returns true if the board reached the goal.
+ */
+bool isSolvedPuzzle( const Board *board, PuzzleGoal goal );
+
+/**
+ * @brief Plays a swap with the puzzle rules (no refill). Returns false,
+ * leaving the board unchanged, if the swap makes no match.
+ */
+bool applyMovePuzzle( Board *board, Move move );
+
+/**
+ * @brief Finds a shortest sequence of at most maxDepth swaps that takes a
+ * stable board (of at most 8 x 8 cells) to the goal. Iterative deepening
+ * search: each depth is a batch of jobs on pool, one per first move (on
+ * the calling thread when pool is NULL), and the lowest first move that
+ * solves it wins, so the answer does not depend on the scheduling.
+ * Branches are pruned when a color the goal must clear has one or two
+ * pieces left (no refill can complete them) and when a lock-free
+ * transposition table, shared by the jobs, knows the board has no
+ * solution within the moves left. table, when not NULL, is used instead
+ * of a table of PUZZLE_TABLE_BITS allocated for the solve, and keeps its
+ * entries for the next solves (they hold for any later board and goal).
+ * Returns solution->solved (always false for larger boards).
+ */
+bool solvePuzzle( const Board *board, PuzzleGoal goal, int maxDepth, ThreadPool *pool,
+                  TranspositionTable *table, PuzzleSolution *solution );
+
+/**
+ * @brief Starts solving a copy of a stable board (of at most 8 x 8 cells)
+ * with up to maxDepth swaps, dropping the previous solve. Nothing is
+ * searched until stepAnytimePuzzle is called; boards already at the goal
+ * or hopeless are finished at once. table must not be NULL: it keeps what
+ * a depth cut short already proved.
+ */
+void startAnytimePuzzle( AnytimePuzzle *anytime, const Board *board, PuzzleGoal goal, int maxDepth,
+                         TranspositionTable *table );
+
+/**
+ * @brief Advances the solve for about budget microseconds, on the calling
+ * thread. A depth the budget cuts short is searched again by the next
+ * call, which skips the branches the table proved meanwhile, so every
+ * call makes progress. solution->microseconds adds up the time of the
+ * calls. Returns true once the solve finished (solved, proven unsolvable
+ * or searched up to maxDepth).
+ */
+bool stepAnytimePuzzle( AnytimePuzzle *anytime, uint64_t budget );
@@ -0,0 +1,92 @@
+/**
+ * @file Replay.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Replay struct and function declarations. A replay is the seed of
+ * a board plus every accepted swap with the frame it was made at, which is
+ * enough to rebuild the whole session with the headless cascade resolver.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "Cascade.h"
+
+typedef struct ReplayMove {
+    uint32_t frame;
+    uint16_t r1;
+    uint16_t c1;
+    uint16_t r2;
+    uint16_t c2;
+} ReplayMove;
+
+typedef struct Replay {
+    uint64_t seed;
+    int width;
+    int height;
+    ReplayMove *moves;
+    int moveCount;
+    int moveCapacity;
+} Replay;
+
+typedef struct ReplayStats {
+    int moves;
+    int rejectedMoves;
+    int cascades;
+    int maxDepth;
+    int reshuffles;
+    long long clearedCells;
+} ReplayStats;
+
+/**
+ * @brief Creates a dinamically allocated, empty Replay struct instance.
+ */
+Replay* createReplay( uint64_t seed, int width, int height );
+
+/**
+ * @brief Destroys a Replay object and its moves.
+ */
+void destroyReplay( Replay *replay );
+
+/**
+ * @brief Removes every move and starts recording a board with a new seed.
+ */
+void clearReplay( Replay *replay, uint64_t seed );
+
+/**
+ * @brief Records an accepted swap.
+ */
+void addMoveReplay( Replay *replay, uint32_t frame, Move move );
+
+/**
+ * @brief Builds the initial board of a seed, exactly like the game does.
+ * The cells of board must have room for width x height cells. rng is left
+ * ready to produce the first refill.
+ */
+void buildInitialBoardReplay( Board *board, Rng *rng, uint64_t seed, int width, int height );
+
+/**
+ * @brief Re-executes every move of the replay with the headless cascade
+ * resolver, at full speed and without rendering. Boards left without legal
+ * moves are reshuffled, like the game does. The final board is stored in
+ * board, whose cells must have room for the replay board, and the totals
+ * in stats (may be NULL). Returns true if every recorded move was
+ * accepted again.
+ */
+bool playReplay( const Replay *replay, Board *board, ReplayStats *stats );
+
+/**
+ * @brief Saves the replay in a compact binary format. Returns true on
+ * success.
+ */
+bool saveReplay( const Replay *replay, const char *path );
+
+/**
+ * @brief Loads a replay saved with saveReplay. Returns NULL on failure or
+ * when the board size is not supported.
+ */
+Replay* loadReplay( const char *path );
@@ -0,0 +1,47 @@
+/**
+ * @file Rng.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Rng struct and function declarations. A small, seedable PCG32
+ * random number generator. Each generator owns its state and can be
+ * placed on one of 2^63 independent streams, so boards and simulations
+ * running side by side never share or disturb each other's sequence.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "Types.h"
+
+typedef struct Rng {
+    uint64_t state;
+    uint64_t increment;
+} Rng;
+
+/**
+ * @brief Seeds the generator. Generators with the same seed but different
+ * streams produce independent sequences.
+ */
+void seedRng( Rng *rng, uint64_t seed, uint64_t stream );
+
+/**
+ * @brief Returns the next 32 bit value of the sequence.
+ */
+uint32_t nextRng( Rng *rng );
+
+/**
+ * @brief Returns a value in [0, bound).
+ */
+int boundedRng( Rng *rng, int bound );
+
+/**
+ * @brief Returns a random piece type (never PIECE_NULL).
+ */
+PieceType nextPieceRng( Rng *rng );
+
+/**
+ * @brief Fills pieces with count random piece types (never PIECE_NULL).
+ * Produces the same values as count calls to nextPieceRng.
+ */
+void fillPiecesRng( Rng *rng, uint8_t *pieces, int count );
@@ -0,0 +1,52 @@
+/**
+ * @file RunMask.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Run mask function declarations. A run mask marks, one byte per
+ * cell, the cells of a byte-packed board (one piece type per byte, row
+ * after row) that belong to a horizontal or vertical run of three or more
+ * pieces of the same type. It is the board-size independent counterpart
+ * of findAllMatchesBitBoard, with SIMD kernels for large boards.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum RunKernel {
+    RUN_KERNEL_SCALAR,
+    RUN_KERNEL_SSE2,
+    RUN_KERNEL_AVX2,
+    RUN_KERNEL_COUNT
+} RunKernel;
+
+/**
+ * @brief Returns true if the kernel was compiled in and the CPU running
+ * the program supports it. The scalar kernel is always supported.
+ */
+bool isSupportedKernelRunMask( RunKernel kernel );
+
+/**
+ * @brief Returns the fastest kernel the CPU supports.
+ */
+RunKernel getBestKernelRunMask( void );
+
+/**
+ * @brief Returns the name of a kernel.
+ */
+const char *getKernelNameRunMask( RunKernel kernel );
+
+/**
+ * @brief Stores in mask (width * height bytes) 1 for every cell of cells
+ * that belongs to a run of three or more equal pieces and 0 for the
+ * others. PIECE_NULL cells never match. Returns how many cells were
+ * marked. Uses the fastest kernel the CPU supports, picked on the first call.
+ */
+int findRunMask( const uint8_t *cells, int width, int height, uint8_t *mask );
+
+/**
+ * @brief Same as findRunMask, with the given kernel, which must be
+ * supported. Every kernel produces exactly the same mask.
+ */
+int findWithKernelRunMask( RunKernel kernel, const uint8_t *cells, int width, int height, uint8_t *mask );
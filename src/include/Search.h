@@ -0,0 +1,136 @@
+/**
+ * @file Search.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Search struct and function declarations. Expectimax search of the
+ * best swap: the player's moves are max nodes and the random refills of
+ * the cascades are chance nodes, estimated by sampling.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "BitBoard.h"
+#include "Cascade.h"
+#include "PackedBoard.h"
+#include "TranspositionTable.h"
+
+#define SEARCH_MAX_DEPTH 4
+#define SEARCH_MAX_SAMPLES 64
+#define SEARCH_MOVE_CAPACITY ( 2 * BITBOARD_CELLS )
+
+/**
+ * @brief depth is how many moves ahead are searched (1 evaluates only the
+ * next move) and samples how many refills each chance node draws. seed
+ * selects the refills drawn; it never touches the game random numbers.
+ */
+typedef struct SearchConfig {
+    int depth;
+    int samples;
+    uint64_t seed;
+} SearchConfig;
+
+typedef struct SearchResult {
+    bool found;
+    Move move;
+    float expectedScore;
+    int depth;
+    int moveCount;
+    long long nodes;
+    long long tableHits;
+} SearchResult;
+
+/**
+ * @brief Search state. Only boards of at most 8 x 8 cells are searched.
+ * Every board of the search is copied to cells on the stack (one byte per
+ * cell) and the move lists of each ply are stored here, so a search never
+ * allocates memory. When table is not NULL, boards
+ * already evaluated to the same depth (by this or any other search
+ * sharing the table) are answered from it.
+ */
+typedef struct Search {
+    SearchConfig config;
+    TranspositionTable *table;
+    Cascade cascade;
+    Move moves[SEARCH_MAX_DEPTH][SEARCH_MOVE_CAPACITY];
+    long long nodes;
+    long long tableHits;
+} Search;
+
+/**
+ * @brief A board of the anytime search stack, packed, with the move and
+ * sample being evaluated on it.
+ */
+typedef struct AnytimeFrame {
+    PackedBoard board;
+    uint64_t hash;
+    int moveCount;
+    int moveIndex;
+    int sample;
+    float cleared;
+    float total;
+    float best;
+    Move bestMove;
+} AnytimeFrame;
+
+/**
+ * @brief Resumable search for the game loop. It deepens one ply at a time
+ * up to config.depth and can be paused after any cascade, so the work of
+ * a frame is bounded by a time budget. best always holds the answer of
+ * the last completed depth (the first legal move before that).
+ */
+typedef struct AnytimeSearch {
+    Search search;
+    int maxDepth;
+    int depth;
+    int ply;
+    AnytimeFrame frames[SEARCH_MAX_DEPTH];
+    SearchResult best;
+    bool finished;
+} AnytimeSearch;
+
+/**
+ * @brief Prepares a search with the given configuration, clamping depth
+ * and samples to the supported ranges. table may be NULL.
+ */
+void initSearch( Search *search, SearchConfig config, TranspositionTable *table );
+
+/**
+ * @brief Lists the legal moves of a stable board in moves, returning how
+ * many there are. Boards larger than 8 x 8 cells are not searched and
+ * get no moves.
+ */
+int listMovesSearch( const Board *board, Move *moves );
+
+/**
+ * @brief Evaluates every legal move of a stable board and stores the one
+ * with the highest expected score (cells cleared over the next
+ * config.depth moves) in result. Returns false when the board has no
+ * legal move.
+ */
+bool findBestMoveSearch( Search *search, const Board *board, SearchResult *result );
+
+/**
+ * @brief Prepares an anytime search that deepens up to config.depth. It
+ * does nothing until startAnytimeSearch gives it a board.
+ */
+void initAnytimeSearch( AnytimeSearch *anytime, SearchConfig config, TranspositionTable *table );
+
+/**
+ * @brief Starts searching a new stable board, dropping the previous one.
+ * The first legal move is available as the current best move right away.
+ */
+void startAnytimeSearch( AnytimeSearch *anytime, const Board *board );
+
+/**
+ * @brief Advances the search for about budget microseconds. The search
+ * keeps its own stack of boards instead of recursing, so it can stop
+ * after any single cascade and resume from there on the next call. Each
+ * completed depth replaces the best move. Returns true once the search
+ * reached config.depth.
+ */
+bool stepAnytimeSearch( AnytimeSearch *anytime, uint64_t budget );
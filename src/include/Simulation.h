@@ -0,0 +1,107 @@
+/**
+ * @file Simulation.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation struct and function declarations. Plays complete games
+ * headlessly with the cascade resolver, choosing each swap with a move
+ * policy, and gathers statistics over batches of games.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+#include "BitBoard.h"
+#include "Match.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+
+#define SIMULATION_MOVE_CAPACITY ( 2 * BITBOARD_CELLS )
+#define SIMULATION_DEPTH_BUCKETS 16
+
+/**
+ * @brief Chooses one of the moveCount legal moves of a stable board and
+ * returns its index. rng is private to the game being played; data is
+ * the data of the MovePolicy and is shared by every thread.
+ */
+typedef int (*ChooseMoveFunction)( const Board *board, const Move *moves, int moveCount, Rng *rng, const void *data );
+
+typedef struct MovePolicy {
+    const char *name;
+    const char *description;
+    ChooseMoveFunction choose;
+    const void *data;
+} MovePolicy;
+
+/**
+ * @brief How the games are played. Boards are of at most 8 x 8 cells, the
+ * size of the bitboards the move lists come from.
+ */
+typedef struct SimulationConfig {
+    int width;
+    int height;
+    int maxMoves;
+    bool reshuffle;
+    const MovePolicy *policy;
+} SimulationConfig;
+
+/**
+ * @brief Statistics of one or more games. depth[d] counts the moves whose
+ * cascade had depth d (the last bucket also counts deeper ones) and
+ * shapes the groups matched of each MatchShape.
+ */
+typedef struct SimulationStats {
+    long long games;
+    long long moves;
+    long long reshuffles;
+    long long clearedCells;
+    long long depth[SIMULATION_DEPTH_BUCKETS];
+    long long shapes[MATCH_SHAPE_CROSS + 1];
+    int minMoves;
+    int maxMoves;
+    uint64_t policyMicroseconds;
+    uint64_t resolveMicroseconds;
+} SimulationStats;
+
+/**
+ * @brief Returns the policy with the given name, or NULL if there is none.
+ */
+const MovePolicy *findMovePolicy( const char *name );
+
+/**
+ * @brief Returns the available policies, storing how many there are in
+ * count.
+ */
+const MovePolicy *getMovePolicies( int *count );
+
+/**
+ * @brief Resets every counter of the statistics.
+ */
+void clearSimulationStats( SimulationStats *stats );
+
+/**
+ * @brief Adds the counters of src to dst.
+ */
+void mergeSimulationStats( SimulationStats *dst, const SimulationStats *src );
+
+/**
+ * @brief Plays a complete game from the board that seed generates (the
+ * same board a replay with this seed starts from). The game ends when the
+ * board runs out of moves or after config->maxMoves moves; with
+ * config->reshuffle the board is reshuffled like in the game instead, so
+ * only the move limit ends it. Adds the game to stats and returns how many
+ * moves were played.
+ */
+int playGameSimulation( const SimulationConfig *config, uint64_t seed, SimulationStats *stats );
+
+/**
+ * @brief Plays gameCount games on the pool, game i using seed + i, and
+ * stores their combined statistics in stats. Each worker gathers its own
+ * statistics, merged at the end, so workers never wait for each other.
+ * When movesPerGame is not NULL it receives the moves of each game.
+ */
+void runSimulation( ThreadPool *pool, const SimulationConfig *config, uint64_t seed, int gameCount,
+                    SimulationStats *stats, int *movesPerGame );
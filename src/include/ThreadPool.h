@@ -0,0 +1,70 @@
+/**
+ * @file ThreadPool.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ThreadPool struct and function declarations. A fixed set of
+ * worker threads that run batches of independent jobs. Each worker owns a
+ * range of the jobs of a batch and, when it runs out, steals half of the
+ * jobs left in another worker's range.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+
+/**
+ * @brief A job of a batch. worker is the index of the thread running it
+ * (0 up to the thread count - 1), so jobs can use per-worker data without
+ * locking.
+ */
+typedef void (*JobFunction)( void *data, int job, int worker );
+
+/**
+ * @brief The jobs [next, end) still owned by a worker. The owner takes
+ * jobs from next and thieves take them from end.
+ */
+typedef struct JobRange {
+    pthread_mutex_t lock;
+    int next;
+    int end;
+} JobRange;
+
+typedef struct ThreadPool {
+    int threadCount;
+    pthread_t *threads;
+    JobRange *ranges;
+    pthread_mutex_t lock;
+    pthread_cond_t batchReady;
+    pthread_cond_t batchDone;
+    JobFunction function;
+    void *data;
+    int activeWorkers;
+    int batch;
+    bool stopping;
+} ThreadPool;
+
+/**
+ * @brief Creates a dinamically allocated ThreadPool with threadCount
+ * workers (all available cores when threadCount <= 0).
+ */
+ThreadPool* createThreadPool( int threadCount );
+
+/**
+ * @brief Stops the workers and destroys the ThreadPool.
+ */
+void destroyThreadPool( ThreadPool *pool );
+
+/**
+ * @brief Runs function for every job in [0, jobCount) on the workers and
+ * waits until all of them finish. Worker i starts with the i-th slice of
+ * the jobs and idle workers steal from busy ones, so uneven jobs are
+ * balanced while each worker mostly runs neighboring jobs. When pool is
+ * NULL the jobs run in order on the calling thread, as worker 0.
+ */
+void runThreadPool( ThreadPool *pool, int jobCount, JobFunction function, void *data );
+
+/**
+ * @brief Returns how many cores are available.
+ */
+int getCoreCount( void );
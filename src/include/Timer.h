@@ -0,0 +1,17 @@
+/**
+ * @file Timer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Monotonic clock used to measure the headless engine, which does
+ * not depend on raylib's GetTime.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Returns the microseconds elapsed since an arbitrary point in the
+ * past. Never goes backwards.
+ */
+uint64_t getMicrosecondsTimer( void );
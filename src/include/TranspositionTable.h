@@ -0,0 +1,69 @@
+/**
+ * @file TranspositionTable.h
+ * @author Prof. Dr. David Buzatto
+ * @brief TranspositionTable struct and function declarations. A fixed-size
+ * table of evaluated boards, indexed by their Zobrist hash, that many
+ * threads can read and write at the same time without locks.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+
+/**
+ * @brief data packs the value (a float, bits 0 to 31), the depth it was
+ * searched to (bits 32 to 39) and the best move (its first cell in bits
+ * 40 to 61 and whether it goes down in bit 62). check is the hash XOR
+ * data: an entry torn by two threads writing it at once fails the check
+ * and reads as a miss, so no lock is needed.
+ */
+typedef struct TableEntry {
+    uint64_t check;
+    uint64_t data;
+} TableEntry;
+
+typedef struct TranspositionTable {
+    TableEntry *entries;
+    uint64_t mask;
+    int width;
+} TranspositionTable;
+
+typedef struct TableProbe {
+    float value;
+    int depth;
+    Move bestMove;
+} TableProbe;
+
+/**
+ * @brief Creates a dinamically allocated table with 2^sizeBits entries
+ * (16 bytes each) for boards width cells wide.
+ */
+TranspositionTable* createTranspositionTable( int sizeBits, int width );
+
+/**
+ * @brief Destroys a table.
+ */
+void destroyTranspositionTable( TranspositionTable *table );
+
+/**
+ * @brief Forgets every entry. Must not run while other threads use the
+ * table.
+ */
+void clearTranspositionTable( TranspositionTable *table );
+
+/**
+ * @brief Stores the value and best move of the board with the given hash,
+ * searched depth moves ahead. An entry of another board is always
+ * replaced; one of the same board only by a search at least as deep.
+ */
+void storeTranspositionTable( TranspositionTable *table, uint64_t hash, float value, int depth, Move bestMove );
+
+/**
+ * @brief Looks up the board with the given hash, filling probe and
+ * returning true when it is stored.
+ */
+bool probeTranspositionTable( const TranspositionTable *table, uint64_t hash, TableProbe *probe );
@@ -2,6 +2,8 @@
 
 #include <stdbool.h>
 
+#define PIECE_TYPE_COUNT 8
+
 typedef enum PieceType {
     PIECE_NULL,
     PIECE_RED,
@@ -18,21 +20,21 @@ typedef enum GameState {
     GAME_STATE_DROPPING_NEW_PIECES
 } GameState;
 
-typedef struct Piece {
-    PieceType type;
-    Vector2 pos;
-    Vector2 dim;
-    bool selected;
-    bool checked;
-    bool debug;
-} Piece;
-
-typedef struct FallingPiece {
-    Piece *piece;
-    float targetY;
-} FallingPiece;
+// render state of a piece, kept apart from its type
+typedef enum PieceFlag {
+    PIECE_FLAG_SELECTED = 1,
+    PIECE_FLAG_CHECKED = 2,
+    PIECE_FLAG_FALLING = 4
+} PieceFlag;
 
 typedef struct Position {
     int row;
     int col;
-} Position;
\ No newline at end of file
+} Position;
+
+typedef struct Move {
+    int r1;
+    int c1;
+    int r2;
+    int c2;
+} Move;
\ No newline at end of file
@@ -0,0 +1,41 @@
+/**
+ * @file Zobrist.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Zobrist hashing of boards. The hash of a board is the XOR of one
+ * 64 bit key per ( cell, piece type ) pair, so placing, removing or moving
+ * a piece updates it with one or two XORs.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "Types.h"
+#include "Board.h"
+
+/**
+ * @brief Returns the key of a piece of the given type at cell
+ * ( row * width + col ). Empty cells (PIECE_NULL) have key 0. Keys are
+ * computed by a fixed mixing function, so they are the same in every
+ * thread and every run and need no table.
+ */
+uint64_t keyZobrist( int cell, PieceType type );
+
+/**
+ * @brief Returns the hash of every cell of the board.
+ */
+uint64_t hashBoardZobrist( const Board *board );
+
+/**
+ * @brief Returns what must be XORed to the hash of the board when the two
+ * pieces of the move are swapped (the same value before and after the
+ * swap).
+ */
+uint64_t swapZobrist( const Board *board, Move move );
+
+/**
+ * @brief Returns what must be XORed to a hash when a piece of the given
+ * type moves from cell from to cell to (e.g. when it falls).
+ */
+uint64_t moveZobrist( int from, int to, PieceType type );
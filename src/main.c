@@ -12,12 +12,18 @@
 
 #include "GameWindow.h"
 
-int main( void ) {
+int main( int argc, char **argv ) {
+
+    // optional board size: bejeweled [width height]
+    int boardWidth = argc >= 3 ? atoi( argv[1] ) : GAME_DEFAULT_SIZE;
+    int boardHeight = argc >= 3 ? atoi( argv[2] ) : GAME_DEFAULT_SIZE;
 
     GameWindow *gameWindow = createGameWindow(
         800,             // width
         800,             // height
         "Bejeweled",     // title
+        boardWidth,      // board width, in pieces
+        boardHeight,     // board height, in pieces
         60,              // target FPS
         true,            // antialiasing
         false,           // resizable
@@ -0,0 +1,145 @@
+/**
+ * @file bot.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless Monte Carlo tree search bot. Plays a game with the
+ * root-parallel MCTS on every core, reporting the score and the playout
+ * throughput.
+ *
+ * Usage:
+ *    bot [options]
+ *       -moves <n>: moves to play (default 50)
+ *       -playouts <n>: playouts per move (default 20000)
+ *       -trees <n>: independent trees per move (default: 4 per thread)
+ *       -horizon <n>: moves per playout (default 8)
+ *       -exploration <c>: UCB1 constant in cells (default 10)
+ *       -threads <n>: worker threads (default: every core)
+ *       -seed <n>: game seed (default: current time)
+ *       -quiet: only prints the summary
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "Board.h"
+#include "BitBoard.h"
+#include "BoardGenerator.h"
+#include "Cascade.h"
+#include "Mcts.h"
+#include "Replay.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+#define DEFAULT_MOVES 50
+#define DEFAULT_PLAYOUTS 20000
+#define DEFAULT_HORIZON 8
+#define DEFAULT_EXPLORATION 10.0f
+#define TREES_PER_THREAD 4
+
+static void printUsage( const char *program ) {
+    fprintf( stderr, "usage: %s [-moves n] [-playouts n] [-trees n] [-horizon n] [-exploration c]\n", program );
+    fprintf( stderr, "       %*s [-threads n] [-seed n] [-quiet]\n", (int) strlen( program ), "" );
+}
+
+int main( int argc, char **argv ) {
+
+    int moves = DEFAULT_MOVES;
+    int threads = 0;
+    bool quiet = false;
+    uint64_t seed = (uint64_t) time( NULL );
+    MctsConfig config = {
+        .playouts = DEFAULT_PLAYOUTS,
+        .trees = 0,
+        .horizon = DEFAULT_HORIZON,
+        .exploration = DEFAULT_EXPLORATION,
+        .seed = 0
+    };
+
+    for ( int i = 1; i < argc; i++ ) {
+        bool hasValue = i + 1 < argc;
+        if ( strcmp( argv[i], "-moves" ) == 0 && hasValue ) {
+            moves = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-playouts" ) == 0 && hasValue ) {
+            config.playouts = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-trees" ) == 0 && hasValue ) {
+            config.trees = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-horizon" ) == 0 && hasValue ) {
+            config.horizon = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-exploration" ) == 0 && hasValue ) {
+            config.exploration = (float) atof( argv[++i] );
+        } else if ( strcmp( argv[i], "-threads" ) == 0 && hasValue ) {
+            threads = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-seed" ) == 0 && hasValue ) {
+            seed = strtoull( argv[++i], NULL, 10 );
+        } else if ( strcmp( argv[i], "-quiet" ) == 0 ) {
+            quiet = true;
+        } else {
+            printUsage( argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    ThreadPool *pool = createThreadPool( threads );
+    if ( config.trees <= 0 ) {
+        config.trees = pool->threadCount * TREES_PER_THREAD;
+    }
+    Mcts *mcts = createMcts( config, pool->threadCount );
+
+    uint8_t cells[BITBOARD_CELLS];
+    Board board = { .cells = cells };
+    Rng rng;
+    Cascade cascade;
+    MctsResult result;
+    long long clearedCells = 0;
+    long long playouts = 0;
+    double searchSeconds = 0;
+    int played = 0;
+
+    buildInitialBoardReplay( &board, &rng, seed, BITBOARD_SIZE, BITBOARD_SIZE );
+
+    printf( "playing %d moves, %d playouts per move in %d trees on %d threads (seed %llu)\n",
+            moves, mcts->config.playouts, mcts->config.trees, pool->threadCount, (unsigned long long) seed );
+
+    while ( played < moves ) {
+
+        // the search draws its own refills; the game rng only resolves
+        // the chosen move, like in the game
+        mcts->config.seed = seed + (uint64_t) played + 1;
+        if ( !findBestMoveMcts( mcts, pool, &board, &result ) ) {
+            break;
+        }
+
+        resolveSwapBoard( &board, result.move, &rng, &cascade );
+        ensureMovesBoard( &board, &rng );
+
+        played++;
+        clearedCells += cascade.clearedCells;
+        playouts += result.playouts;
+        searchSeconds += result.seconds;
+
+        if ( !quiet ) {
+            printf( "%4d: (%d, %d) -> (%d, %d), expected %6.2f, cleared %3d, depth %2d, %9.0f playouts/s\n",
+                    played, result.move.r1, result.move.c1, result.move.r2, result.move.c2,
+                    result.expectedScore, cascade.clearedCells, cascade.depth, result.playoutsPerSecond );
+        }
+
+    }
+
+    printf( "moves: %d, cleared cells: %lld, %.2f cells per move\n",
+            played, clearedCells, played > 0 ? (double) clearedCells / played : 0.0 );
+    if ( searchSeconds > 0 ) {
+        printf( "playouts: %lld in %.3f s: %.0f playouts/s, %.0f playouts/s per thread\n",
+                playouts, searchSeconds, playouts / searchSeconds, playouts / searchSeconds / pool->threadCount );
+    }
+
+    destroyMcts( mcts );
+    destroyThreadPool( pool );
+
+    return EXIT_SUCCESS;
+
+}
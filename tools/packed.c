@@ -0,0 +1,199 @@
+/**
+ * @file packed.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless packed board check. Fills random boards (empty cells
+ * included) of random sizes and checks every PackedBoard function against
+ * the byte boards: load and store round trips, the planes against
+ * loadBitBoard, equality, hashes, copies and lookups of packed boards,
+ * and encode and decode round trips of boards of any size, which must
+ * reject truncated streams. Reports the time each conversion takes.
+ *
+ * Usage:
+ *    packed [-boards n] [-empty percent] [-seed n]
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "BitBoard.h"
+#include "Board.h"
+#include "PackedBoard.h"
+#include "Rng.h"
+#include "Timer.h"
+#include "Types.h"
+
+// the encoded boards go up to this many cells per side
+#define MAX_ENCODED_SIZE 300
+
+// random pieces, with empty cells at the given percentage
+static void fillBoard( Rng *rng, Board *board, int empty ) {
+
+    int count = board->width * board->height;
+
+    fillPiecesRng( rng, board->cells, count );
+    for ( int k = 0; k < count; k++ ) {
+        if ( boundedRng( rng, 100 ) < empty ) {
+            board->cells[k] = PIECE_NULL;
+        }
+    }
+
+}
+
+int main( int argc, char **argv ) {
+
+    int boards = 100000;
+    int empty = 10;
+    uint64_t seed = 1;
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp( argv[i], "-boards" ) == 0 && i + 1 < argc ) {
+            boards = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-empty" ) == 0 && i + 1 < argc ) {
+            empty = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-seed" ) == 0 && i + 1 < argc ) {
+            seed = strtoull( argv[++i], NULL, 10 );
+        } else {
+            fprintf( stderr, "usage: %s [-boards n] [-empty percent] [-seed n]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( boards < 1 ) {
+        fprintf( stderr, "boards must be positive\n" );
+        return EXIT_FAILURE;
+    }
+
+    uint8_t cells[BITBOARD_CELLS];
+    uint8_t storedCells[BITBOARD_CELLS];
+    Board board = { .cells = cells };
+    Board stored = { .cells = storedCells };
+    PackedBoard *packed = (PackedBoard*) malloc( boards * sizeof( PackedBoard ) );
+    PackedBoard *copies = (PackedBoard*) malloc( boards * sizeof( PackedBoard ) );
+    int failures = 0;
+    Rng rng;
+
+    seedRng( &rng, seed, 0 );
+
+    for ( int b = 0; b < boards; b++ ) {
+
+        initBoard( &board, 1 + boundedRng( &rng, BITBOARD_SIZE ), 1 + boundedRng( &rng, BITBOARD_SIZE ), cells );
+        fillBoard( &rng, &board, empty );
+
+        loadPackedBoard( &packed[b], &board );
+        storePackedBoard( &packed[b], &stored );
+
+        if ( !equalsBoard( &stored, &board ) ) {
+            printf( "board %d (%d x %d): load and store do not round trip\n", b, board.width, board.height );
+            failures++;
+        }
+
+        BitBoard expected;
+        BitBoard planes;
+        loadBitBoard( &expected, &board );
+        toBitBoardPackedBoard( &packed[b], &planes );
+
+        if ( memcmp( &expected, &planes, sizeof( BitBoard ) ) != 0 ) {
+            printf( "board %d (%d x %d): the planes differ from loadBitBoard\n", b, board.width, board.height );
+            failures++;
+        }
+
+        // a copy is equal and hashes the same, one changed cell is not
+        PackedBoard other;
+        loadPackedBoard( &other, &stored );
+        int cell = boundedRng( &rng, board.width * board.height );
+        bool same = equalsPackedBoard( &packed[b], &other ) &&
+                    hashPackedBoard( &packed[b] ) == hashPackedBoard( &other );
+
+        stored.cells[cell] = ( stored.cells[cell] + 1 ) % PIECE_TYPE_COUNT;
+        loadPackedBoard( &other, &stored );
+
+        if ( !same || equalsPackedBoard( &packed[b], &other ) ) {
+            printf( "board %d (%d x %d): equality or hash is wrong\n", b, board.width, board.height );
+            failures++;
+        }
+
+    }
+
+    // timed apart from the checks, a single board being too quick for the
+    // clock
+    uint64_t start = getMicrosecondsTimer();
+    for ( int b = 0; b < boards; b++ ) {
+        storePackedBoard( &packed[b], &stored );
+    }
+    uint64_t storeMicros = getMicrosecondsTimer() - start;
+
+    start = getMicrosecondsTimer();
+    for ( int b = 0; b < boards; b++ ) {
+        loadPackedBoard( &copies[b], &stored );
+    }
+    uint64_t loadMicros = getMicrosecondsTimer() - start;
+
+    // every board is found at its own index or at an earlier equal one
+    copyPackedBoards( copies, packed, boards );
+
+    for ( int b = 0; b < boards; b += 1 + b / 64 ) {
+        int found = findPackedBoard( copies, boards, &packed[b] );
+        if ( found < 0 || found > b || !equalsPackedBoard( &copies[found], &packed[b] ) ||
+             findPackedBoard( copies, found, &packed[b] ) != -1 ) {
+            printf( "board %d: found at %d\n", b, found );
+            failures++;
+        }
+    }
+
+    // encoded boards of any size, up to MAX_ENCODED_SIZE cells per side
+    int encodedBoards = boards / 100 + 1;
+    uint8_t *large = (uint8_t*) malloc( MAX_ENCODED_SIZE * MAX_ENCODED_SIZE );
+    uint8_t *decodedCells = (uint8_t*) malloc( MAX_ENCODED_SIZE * MAX_ENCODED_SIZE );
+    uint8_t *bytes = (uint8_t*) malloc( getEncodedSizePackedBoard( MAX_ENCODED_SIZE, MAX_ENCODED_SIZE ) );
+    uint64_t encodeMicros = 0;
+    uint64_t decodeMicros = 0;
+    long long encodedCells = 0;
+
+    for ( int b = 0; b < encodedBoards; b++ ) {
+
+        Board source;
+        Board decoded = { .cells = decodedCells };
+        initBoard( &source, 1 + boundedRng( &rng, MAX_ENCODED_SIZE ), 1 + boundedRng( &rng, MAX_ENCODED_SIZE ), large );
+        fillBoard( &rng, &source, empty );
+        encodedCells += source.width * source.height;
+
+        start = getMicrosecondsTimer();
+        size_t size = encodePackedBoard( &source, bytes );
+        uint64_t encoded = getMicrosecondsTimer();
+        bool valid = decodePackedBoard( bytes, size, &decoded );
+        decodeMicros += getMicrosecondsTimer() - encoded;
+        encodeMicros += encoded - start;
+
+        if ( size != getEncodedSizePackedBoard( source.width, source.height ) || !valid ||
+             !equalsBoard( &decoded, &source ) ) {
+            printf( "encoded board %d (%d x %d): encode and decode do not round trip\n",
+                    b, source.width, source.height );
+            failures++;
+        }
+
+        if ( decodePackedBoard( bytes, size - 1, &decoded ) ) {
+            printf( "encoded board %d (%d x %d): a truncated stream was decoded\n", b, source.width, source.height );
+            failures++;
+        }
+
+    }
+
+    printf( "%d packed boards: load %.1f ns, store %.1f ns per board\n",
+            boards, 1000.0 * loadMicros / boards, 1000.0 * storeMicros / boards );
+    printf( "%d encoded boards: encode %.2f ns, decode %.2f ns per cell\n",
+            encodedBoards, 1000.0 * encodeMicros / encodedCells, 1000.0 * decodeMicros / encodedCells );
+    printf( "%s\n", failures == 0 ? "all checks passed" : "some checks FAILED" );
+
+    free( packed );
+    free( copies );
+    free( large );
+    free( decodedCells );
+    free( bytes );
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
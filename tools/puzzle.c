@@ -0,0 +1,333 @@
+/**
+ * @file puzzle.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless puzzle verifier. Solves puzzle packs (or the built-in
+ * puzzles) with the no-refill rules, reporting whether each puzzle is
+ * solvable and its minimal number of swaps.
+ *
+ * Usage:
+ *    puzzle [-depth n] [-threads n] [file ...]
+ *
+ * A pack is a text file with one or more puzzles separated by blank
+ * lines. A puzzle is a "goal empty" or "goal color <type>" line followed
+ * by its rows, one digit (0 for empty, 1 to 7 for a color) per cell.
+ * Lines starting with # are comments. Without files the built-in puzzles
+ * are solved, which checks that each one is solvable with its goal. Exits
+ * with failure if any puzzle is not solved.
+ *
+ * Puzzles that only differ by their colors or by the column mirror (the
+ * only mirror that keeps gravity) are solved once: they share a canonical
+ * form, and the solution of the first one is mapped to the others and
+ * replayed on them to check it.
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "Board.h"
+#include "Canonical.h"
+#include "Puzzle.h"
+#include "ThreadPool.h"
+
+#define DEFAULT_MAX_DEPTH 8
+#define LINE_CAPACITY 256
+#define NAME_CAPACITY ( LINE_CAPACITY + 32 )
+#define CACHE_CAPACITY 1024
+
+// a solved puzzle in canonical form, its goal relabelled the same way and
+// its moves mirrored the same way
+typedef struct CachedPuzzle {
+    int width;
+    int height;
+    uint8_t cells[PUZZLE_SIZE * PUZZLE_SIZE];
+    PuzzleGoal goal;
+    PuzzleSolution solution;
+    char name[NAME_CAPACITY];
+} CachedPuzzle;
+
+typedef struct PuzzleCache {
+    CachedPuzzle entries[CACHE_CAPACITY];
+    int count;
+} PuzzleCache;
+
+// the goal of a board in terms of the labels of its canonical form; false
+// when the color to clear is not on the board at all
+static bool canonicalGoal( PuzzleGoal goal, const uint8_t *colors, PuzzleGoal *canonical ) {
+
+    *canonical = goal;
+
+    if ( goal.type == PUZZLE_GOAL_EMPTY_BOARD ) {
+        return true;
+    }
+
+    for ( int label = 1; label < PIECE_TYPE_COUNT; label++ ) {
+        if ( colors[label] == goal.color ) {
+            canonical->color = (PieceType) label;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+// plays the solution on a copy of the board: true if every swap matches
+// and the last one reaches the goal
+static bool replaySolution( const Board *board, PuzzleGoal goal, const PuzzleSolution *solution ) {
+
+    uint8_t cells[PUZZLE_SIZE * PUZZLE_SIZE];
+    Board copy = { .cells = cells };
+
+    copyBoard( &copy, board );
+
+    for ( int i = 0; i < solution->moveCount; i++ ) {
+        if ( !applyMovePuzzle( &copy, solution->moves[i] ) ) {
+            return false;
+        }
+    }
+
+    return isSolvedPuzzle( &copy, goal );
+
+}
+
+// solves the board, or maps the solution of an equivalent puzzle solved
+// before; returns the name of that puzzle, or NULL if it was solved now
+static const char *solveCached( const char *name, const Board *board, PuzzleGoal goal, int maxDepth,
+                                ThreadPool *pool, TranspositionTable *table, PuzzleCache *cache,
+                                PuzzleSolution *solution ) {
+
+    uint8_t cells[PUZZLE_SIZE * PUZZLE_SIZE];
+    uint8_t colors[PIECE_TYPE_COUNT];
+    Board canonical = { .cells = cells };
+    PuzzleGoal key;
+
+    int mirror = canonicalizeBoard( board, true, &canonical, colors );
+
+    if ( !canonicalGoal( goal, colors, &key ) ) {
+        solvePuzzle( board, goal, maxDepth, pool, table, solution );
+        return NULL;
+    }
+
+    for ( int i = 0; i < cache->count; i++ ) {
+
+        CachedPuzzle *entry = &cache->entries[i];
+        Board cached = { entry->width, entry->height, entry->cells };
+
+        if ( entry->goal.type == key.type && entry->goal.color == key.color && equalsBoard( &cached, &canonical ) ) {
+            *solution = entry->solution;
+            for ( int j = 0; j < solution->moveCount; j++ ) {
+                solution->moves[j] = mirrorMoveCanonical( solution->moves[j], mirror, board->width, board->height );
+            }
+            return entry->name;
+        }
+
+    }
+
+    solvePuzzle( board, goal, maxDepth, pool, table, solution );
+
+    if ( cache->count < CACHE_CAPACITY ) {
+        CachedPuzzle *entry = &cache->entries[cache->count++];
+        entry->width = canonical.width;
+        entry->height = canonical.height;
+        memcpy( entry->cells, canonical.cells, (size_t) canonical.width * canonical.height );
+        entry->goal = key;
+        entry->solution = *solution;
+        for ( int j = 0; j < solution->moveCount; j++ ) {
+            entry->solution.moves[j] = mirrorMoveCanonical( solution->moves[j], mirror, board->width, board->height );
+        }
+        snprintf( entry->name, sizeof( entry->name ), "%s", name );
+    }
+
+    return NULL;
+
+}
+
+static bool report( const char *name, const Board *board, PuzzleGoal goal, int maxDepth, ThreadPool *pool,
+                    TranspositionTable *table, PuzzleCache *cache ) {
+
+    PuzzleSolution solution;
+    const char *sameAs = solveCached( name, board, goal, maxDepth, pool, table, cache, &solution );
+
+    printf( "%s (%s", name, goal.type == PUZZLE_GOAL_EMPTY_BOARD ? "empty the board" : "clear color " );
+    if ( goal.type == PUZZLE_GOAL_CLEAR_COLOR ) {
+        printf( "%d", goal.color );
+    }
+    printf( "): " );
+
+    if ( solution.solved ) {
+        printf( "minimal solution in %d swaps:", solution.moveCount );
+        for ( int i = 0; i < solution.moveCount; i++ ) {
+            Move m = solution.moves[i];
+            printf( " (%d,%d)-(%d,%d)", m.r1, m.c1, m.r2, m.c2 );
+        }
+    } else if ( solution.unsolvable ) {
+        printf( "UNSOLVABLE" );
+    } else {
+        printf( "NOT SOLVED within %d swaps", maxDepth );
+    }
+
+    if ( sameAs == NULL ) {
+        printf( " [%lld nodes, %.2f ms]\n", solution.nodes, solution.microseconds / 1000.0 );
+    } else if ( solution.solved && !replaySolution( board, goal, &solution ) ) {
+        printf( " [same as %s, but the mapped solution FAILS]\n", sameAs );
+        return false;
+    } else {
+        printf( " [same as %s]\n", sameAs );
+    }
+
+    return solution.solved;
+
+}
+
+// reads the puzzles of a pack, solving each one as soon as it ends
+static bool solvePack( const char *path, int maxDepth, ThreadPool *pool, TranspositionTable *table,
+                       PuzzleCache *cache, int *count ) {
+
+    FILE *file = fopen( path, "r" );
+
+    if ( file == NULL ) {
+        fprintf( stderr, "could not open %s\n", path );
+        return false;
+    }
+
+    char line[LINE_CAPACITY];
+    char name[NAME_CAPACITY];
+    uint8_t pieces[PUZZLE_SIZE * PUZZLE_SIZE];
+    uint8_t cells[PUZZLE_SIZE * PUZZLE_SIZE];
+    Board board;
+    PuzzleGoal goal = { PUZZLE_GOAL_EMPTY_BOARD, PIECE_NULL };
+    bool allSolved = true;
+    bool valid = true;
+    int rows = 0;
+    int lineNumber = 0;
+    int startLine = 0;
+
+    initBoard( &board, 0, 0, cells );
+
+    while ( true ) {
+
+        bool end = fgets( line, sizeof( line ), file ) == NULL;
+        size_t length = end ? 0 : strcspn( line, "\r\n" );
+        line[length] = '\0';
+        lineNumber++;
+
+        if ( !end && line[0] == '#' ) {
+            continue;
+        }
+
+        if ( end || length == 0 ) {
+            if ( rows > 0 ) {
+                snprintf( name, sizeof( name ), "%s:%d", path, startLine );
+                if ( !valid ) {
+                    printf( "%s: INVALID (rows must have the same width, at most %d x %d cells)\n",
+                            name, PUZZLE_SIZE, PUZZLE_SIZE );
+                    allSolved = false;
+                } else {
+                    // rows were read PUZZLE_SIZE cells apart
+                    board.height = rows;
+                    for ( int i = 0; i < rows; i++ ) {
+                        memcpy( &board.cells[i * board.width], &pieces[i * PUZZLE_SIZE], board.width );
+                    }
+                    stabilizePuzzle( &board );
+                    allSolved = report( name, &board, goal, maxDepth, pool, table, cache ) && allSolved;
+                }
+                ( *count )++;
+            }
+            if ( end ) {
+                break;
+            }
+            goal = (PuzzleGoal) { PUZZLE_GOAL_EMPTY_BOARD, PIECE_NULL };
+            rows = 0;
+            valid = true;
+            continue;
+        }
+
+        int color;
+        if ( strcmp( line, "goal empty" ) == 0 ) {
+            goal = (PuzzleGoal) { PUZZLE_GOAL_EMPTY_BOARD, PIECE_NULL };
+        } else if ( sscanf( line, "goal color %d", &color ) == 1 && color > 0 && color < PIECE_TYPE_COUNT ) {
+            goal = (PuzzleGoal) { PUZZLE_GOAL_CLEAR_COLOR, (PieceType) color };
+        } else {
+            int width = 0;
+            if ( rows == 0 ) {
+                startLine = lineNumber;
+            }
+            for ( size_t i = 0; i < length; i++ ) {
+                if ( isdigit( (unsigned char) line[i] ) && line[i] - '0' < PIECE_TYPE_COUNT &&
+                     width < PUZZLE_SIZE && rows < PUZZLE_SIZE ) {
+                    pieces[rows * PUZZLE_SIZE + width++] = (uint8_t) ( line[i] - '0' );
+                } else if ( !isspace( (unsigned char) line[i] ) && line[i] != ',' ) {
+                    valid = false;
+                }
+            }
+            if ( rows == 0 ) {
+                board.width = width;
+            }
+            valid = valid && width == board.width && rows < PUZZLE_SIZE;
+            rows++;
+        }
+
+    }
+
+    fclose( file );
+
+    return allSolved;
+
+}
+
+int main( int argc, char **argv ) {
+
+    int maxDepth = DEFAULT_MAX_DEPTH;
+    int threads = 0;
+    int first = 1;
+
+    while ( first + 1 < argc && argv[first][0] == '-' ) {
+        if ( strcmp( argv[first], "-depth" ) == 0 ) {
+            maxDepth = atoi( argv[first + 1] );
+        } else if ( strcmp( argv[first], "-threads" ) == 0 ) {
+            threads = atoi( argv[first + 1] );
+        } else {
+            break;
+        }
+        first += 2;
+    }
+
+    if ( first < argc && argv[first][0] == '-' ) {
+        fprintf( stderr, "usage: %s [-depth n] [-threads n] [file ...]\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool *pool = createThreadPool( threads );
+    TranspositionTable *table = createTranspositionTable( PUZZLE_TABLE_BITS, PUZZLE_SIZE );
+    PuzzleCache *cache = (PuzzleCache*) calloc( 1, sizeof( PuzzleCache ) );
+    bool allSolved = true;
+    int count = 0;
+
+    if ( first == argc ) {
+        for ( int i = 0; i < PUZZLE_BUILTIN_COUNT; i++ ) {
+            uint8_t cells[PUZZLE_SIZE * PUZZLE_SIZE];
+            Board board = { .cells = cells };
+            PuzzleGoal goal;
+            const char *name = loadBuiltinPuzzle( i, &board, &goal );
+            allSolved = report( name, &board, goal, maxDepth, pool, table, cache ) && allSolved;
+            count++;
+        }
+    }
+
+    for ( int i = first; i < argc; i++ ) {
+        allSolved = solvePack( argv[i], maxDepth, pool, table, cache, &count ) && allSolved;
+    }
+
+    printf( "%d puzzles, %s\n", count, allSolved ? "all solved" : "some NOT solved" );
+    destroyThreadPool( pool );
+    destroyTranspositionTable( table );
+    free( cache );
+
+    return allSolved ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
@@ -0,0 +1,115 @@
+/**
+ * @file runs.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless run mask benchmark. Fills random boards of the given
+ * size, checks that every kernel the CPU supports finds exactly the same
+ * runs as the scalar one and reports the time each kernel takes per
+ * board.
+ *
+ * Usage:
+ *    runs [-width n] [-height n] [-boards n] [-empty percent] [-seed n]
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Rng.h"
+#include "RunMask.h"
+#include "Timer.h"
+#include "Types.h"
+
+int main( int argc, char **argv ) {
+
+    int width = 1024;
+    int height = 1024;
+    int boards = 20;
+    int empty = 5;
+    uint64_t seed = 1;
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp( argv[i], "-width" ) == 0 && i + 1 < argc ) {
+            width = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-height" ) == 0 && i + 1 < argc ) {
+            height = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-boards" ) == 0 && i + 1 < argc ) {
+            boards = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-empty" ) == 0 && i + 1 < argc ) {
+            empty = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-seed" ) == 0 && i + 1 < argc ) {
+            seed = strtoull( argv[++i], NULL, 10 );
+        } else {
+            fprintf( stderr, "usage: %s [-width n] [-height n] [-boards n] [-empty percent] [-seed n]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( width < 1 || height < 1 || boards < 1 ) {
+        fprintf( stderr, "width, height and boards must be positive\n" );
+        return EXIT_FAILURE;
+    }
+
+    size_t size = (size_t) width * height;
+    uint8_t *cells = malloc( size );
+    uint8_t *expected = malloc( size );
+    uint8_t *mask = malloc( size );
+    uint64_t micros[RUN_KERNEL_COUNT] = { 0 };
+    long long marked = 0;
+    bool same = true;
+    Rng rng;
+
+    seedRng( &rng, seed, 0 );
+
+    for ( int b = 0; b < boards; b++ ) {
+
+        // some empty cells too, which never match
+        fillPiecesRng( &rng, cells, (int) size );
+        for ( size_t k = 0; k < size; k++ ) {
+            if ( boundedRng( &rng, 100 ) < empty ) {
+                cells[k] = PIECE_NULL;
+            }
+        }
+
+        int count = findWithKernelRunMask( RUN_KERNEL_SCALAR, cells, width, height, expected );
+        marked += count;
+
+        for ( int k = 0; k < RUN_KERNEL_COUNT; k++ ) {
+            if ( isSupportedKernelRunMask( k ) ) {
+                uint64_t start = getMicrosecondsTimer();
+                int kernelCount = findWithKernelRunMask( k, cells, width, height, mask );
+                micros[k] += getMicrosecondsTimer() - start;
+                if ( kernelCount != count || memcmp( mask, expected, size ) != 0 ) {
+                    printf( "board %d: %s kernel differs from the scalar one\n", b, getKernelNameRunMask( k ) );
+                    same = false;
+                }
+            }
+        }
+
+    }
+
+    printf( "%d boards of %d x %d, %.1f%% of the cells in runs\n",
+            boards, width, height, 100.0 * marked / ( (double) size * boards ) );
+
+    for ( int k = 0; k < RUN_KERNEL_COUNT; k++ ) {
+        if ( isSupportedKernelRunMask( k ) ) {
+            printf( "%-6s %10.1f us per board, %6.2f ns per cell, %5.2fx scalar%s\n",
+                    getKernelNameRunMask( k ),
+                    (double) micros[k] / boards,
+                    1000.0 * micros[k] / ( (double) size * boards ),
+                    micros[k] > 0 ? (double) micros[RUN_KERNEL_SCALAR] / micros[k] : 0.0,
+                    k == (int) getBestKernelRunMask() ? " (selected)" : "" );
+        } else {
+            printf( "%-6s not supported\n", getKernelNameRunMask( k ) );
+        }
+    }
+
+    free( cells );
+    free( expected );
+    free( mask );
+
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
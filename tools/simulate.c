@@ -0,0 +1,155 @@
+/**
+ * @file simulate.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless batch simulator. Plays many complete games in parallel,
+ * one game per job of a thread pool, and reports aggregate statistics.
+ *
+ * Usage:
+ *    simulate [options]
+ *       -games <n>: how many games to play (default 10000)
+ *       -threads <n>: worker threads (default: every core)
+ *       -policy <name>: move policy (default greedy, -policies lists them)
+ *       -moves <n>: move limit of a game (default 1000)
+ *       -reshuffle: reshuffle boards without moves, like the game does
+ *       -seed <n>: seed of the first game (default: current time)
+ *       -policies: lists the move policies
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "Board.h"
+#include "Match.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+#define DEFAULT_GAMES 10000
+#define DEFAULT_MAX_MOVES 1000
+
+static const char *shapeNames[] = { "line 3", "line 4", "line 5", "L", "T", "cross" };
+
+static int compareInts( const void *a, const void *b ) {
+    return *(const int*) a - *(const int*) b;
+}
+
+static void printUsage( const char *program ) {
+    fprintf( stderr, "usage: %s [-games n] [-threads n] [-policy name] [-moves n] [-reshuffle] [-seed n]\n", program );
+    fprintf( stderr, "       %s -policies\n", program );
+}
+
+static void printPolicies( void ) {
+    int count;
+    const MovePolicy *list = getMovePolicies( &count );
+    for ( int i = 0; i < count; i++ ) {
+        printf( "%-10s %s\n", list[i].name, list[i].description );
+    }
+}
+
+static void printStats( const SimulationStats *stats, int *movesPerGame, int threads, double seconds ) {
+
+    double moves = stats->moves > 0 ? (double) stats->moves : 1;
+    long long groups = 0;
+
+    qsort( movesPerGame, stats->games, sizeof( int ), compareInts );
+
+    printf( "games: %lld, moves: %lld, reshuffles: %lld, cleared cells: %lld\n",
+            stats->games, stats->moves, stats->reshuffles, stats->clearedCells );
+    printf( "moves per game: min %d, median %d, p90 %d, max %d, mean %.2f\n",
+            stats->minMoves, movesPerGame[stats->games / 2], movesPerGame[stats->games * 9 / 10],
+            stats->maxMoves, stats->moves / (double) stats->games );
+
+    printf( "cascade depth:\n" );
+    for ( int i = 1; i < SIMULATION_DEPTH_BUCKETS; i++ ) {
+        if ( stats->depth[i] > 0 ) {
+            printf( "    %2d%s %12lld  %6.2f%%\n", i, i == SIMULATION_DEPTH_BUCKETS - 1 ? "+" : " ",
+                    stats->depth[i], 100.0 * stats->depth[i] / moves );
+        }
+    }
+
+    for ( int i = 0; i <= MATCH_SHAPE_CROSS; i++ ) {
+        groups += stats->shapes[i];
+    }
+    printf( "matches by shape:\n" );
+    for ( int i = 0; i <= MATCH_SHAPE_CROSS; i++ ) {
+        printf( "    %-7s %12lld  %6.2f%%\n", shapeNames[i], stats->shapes[i],
+                groups > 0 ? 100.0 * stats->shapes[i] / groups : 0.0 );
+    }
+
+    printf( "time per move: policy %.3f us, resolve %.3f us\n",
+            stats->policyMicroseconds / moves, stats->resolveMicroseconds / moves );
+    printf( "%d threads, %.3f s: %.0f games/s, %.0f moves/s\n",
+            threads, seconds, stats->games / seconds, stats->moves / seconds );
+
+}
+
+int main( int argc, char **argv ) {
+
+    int games = DEFAULT_GAMES;
+    int threads = 0;
+    uint64_t seed = (uint64_t) time( NULL );
+    SimulationConfig config = {
+        .width = BITBOARD_SIZE,
+        .height = BITBOARD_SIZE,
+        .maxMoves = DEFAULT_MAX_MOVES,
+        .reshuffle = false,
+        .policy = findMovePolicy( "greedy" )
+    };
+
+    for ( int i = 1; i < argc; i++ ) {
+        bool hasValue = i + 1 < argc;
+        if ( strcmp( argv[i], "-games" ) == 0 && hasValue ) {
+            games = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-threads" ) == 0 && hasValue ) {
+            threads = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-policy" ) == 0 && hasValue ) {
+            config.policy = findMovePolicy( argv[++i] );
+            if ( config.policy == NULL ) {
+                fprintf( stderr, "unknown policy %s, the available ones are:\n", argv[i] );
+                printPolicies();
+                return EXIT_FAILURE;
+            }
+        } else if ( strcmp( argv[i], "-moves" ) == 0 && hasValue ) {
+            config.maxMoves = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-reshuffle" ) == 0 ) {
+            config.reshuffle = true;
+        } else if ( strcmp( argv[i], "-seed" ) == 0 && hasValue ) {
+            seed = strtoull( argv[++i], NULL, 10 );
+        } else if ( strcmp( argv[i], "-policies" ) == 0 ) {
+            printPolicies();
+            return EXIT_SUCCESS;
+        } else {
+            printUsage( argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( games <= 0 ) {
+        printUsage( argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool *pool = createThreadPool( threads );
+    int *movesPerGame = (int*) malloc( games * sizeof( int ) );
+    SimulationStats stats;
+
+    printf( "playing %d games with the %s policy on %d threads (seed %llu)\n",
+            games, config.policy->name, pool->threadCount, (unsigned long long) seed );
+
+    uint64_t start = getMicrosecondsTimer();
+    runSimulation( pool, &config, seed, games, &stats, movesPerGame );
+    double seconds = ( getMicrosecondsTimer() - start ) / 1e6;
+
+    printStats( &stats, movesPerGame, pool->threadCount, seconds > 0 ? seconds : 1e-6 );
+
+    free( movesPerGame );
+    destroyThreadPool( pool );
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,232 @@
+/**
+ * @file tiles.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless tiled engine benchmark. Fills random boards of the
+ * given size, resolves them with the single-threaded match scan, gravity
+ * and cascade and with their tiled counterparts on pools of 1, 2, 4, ...
+ * threads (taking their scratch from an arena, as the game does), checks
+ * that every result is exactly the same and reports the time each cascade
+ * step takes. Each settled board is then reshuffled, checking that the
+ * pieces are kept and no match is left, and the time it takes is reported
+ * too (the game reshuffles a board that runs out of moves between frames).
+ *
+ * Usage:
+ *    tiles [-width n] [-height n] [-boards n] [-threads n] [-seed n]
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Arena.h"
+#include "Board.h"
+#include "BoardGenerator.h"
+#include "Cascade.h"
+#include "Match.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+#define MAX_POOLS 16
+
+// whether a and b have the same number of pieces of each type
+static bool samePiecesBoard( const Board *a, const Board *b ) {
+
+    int counts[PIECE_TYPE_COUNT] = { 0 };
+
+    for ( int i = 0; i < a->width * a->height; i++ ) {
+        counts[a->cells[i]]++;
+        counts[b->cells[i]]--;
+    }
+
+    for ( int type = 0; type < PIECE_TYPE_COUNT; type++ ) {
+        if ( counts[type] != 0 ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+static bool equalsMatchList( const MatchList *a, const MatchList *b ) {
+    return a->groupCount == b->groupCount && a->cellCount == b->cellCount &&
+           memcmp( a->groups, b->groups, a->groupCount * sizeof( MatchGroup ) ) == 0 &&
+           memcmp( a->cells, b->cells, a->cellCount * sizeof( Position ) ) == 0;
+}
+
+int main( int argc, char **argv ) {
+
+    int width = 1024;
+    int height = 1024;
+    int boards = 4;
+    int threads = getCoreCount();
+    uint64_t seed = 1;
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp( argv[i], "-width" ) == 0 && i + 1 < argc ) {
+            width = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-height" ) == 0 && i + 1 < argc ) {
+            height = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-boards" ) == 0 && i + 1 < argc ) {
+            boards = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-threads" ) == 0 && i + 1 < argc ) {
+            threads = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-seed" ) == 0 && i + 1 < argc ) {
+            seed = strtoull( argv[++i], NULL, 10 );
+        } else {
+            fprintf( stderr, "usage: %s [-width n] [-height n] [-boards n] [-threads n] [-seed n]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( !isValidSizeBoard( width, height ) || boards < 1 || threads < 1 ) {
+        fprintf( stderr, "the board must be from 1 x 1 up to %d x %d and boards and threads positive\n",
+                 BOARD_MAX_SIZE, BOARD_MAX_SIZE );
+        return EXIT_FAILURE;
+    }
+
+    // the serial engine first, then pools of 1, 2, 4, ... threads
+    ThreadPool *pools[MAX_POOLS];
+    int poolCount = 0;
+
+    for ( int t = 1; poolCount < MAX_POOLS; t *= 2 ) {
+        pools[poolCount++] = createThreadPool( t < threads ? t : threads );
+        if ( t >= threads ) {
+            break;
+        }
+    }
+
+    int cellCount = width * height;
+    Board *start = createBoard( width, height );
+    Board *expected = createBoard( width, height );
+    Board *board = createBoard( width, height );
+    MatchList *expectedMatches = createMatchList( cellCount );
+    MatchList *matches = createMatchList( cellCount );
+    Arena *scratch = createArena( 0 );
+    Gravity *gravity = createGravity( width, height );
+    Cascade cascade;
+    Rng rng;
+    Rng reshuffleRng;
+    uint64_t scanMicros[MAX_POOLS + 1] = { 0 };
+    uint64_t resolveMicros[MAX_POOLS + 1] = { 0 };
+    uint64_t reshuffleMicros = 0;
+    uint64_t worstReshuffleMicros = 0;
+    long long steps = 0;
+    bool same = true;
+
+    matches->scratch = scratch;
+    seedRng( &rng, seed, 0 );
+    seedRng( &reshuffleRng, seed, 1 );
+
+    for ( int b = 0; b < boards; b++ ) {
+
+        fillPiecesRng( &rng, start->cells, cellCount );
+        Rng refill = rng;
+
+        // serial reference: one scan and one whole cascade
+        uint64_t begin = getMicrosecondsTimer();
+        findMatchGroups( start, expectedMatches );
+        scanMicros[0] += getMicrosecondsTimer() - begin;
+
+        copyBoard( expected, start );
+        Rng expectedRng = refill;
+        begin = getMicrosecondsTimer();
+        int depth = resolveBoard( expected, &expectedRng, &cascade );
+        resolveMicros[0] += getMicrosecondsTimer() - begin;
+        uint64_t hashDelta = cascade.hashDelta;
+        steps += depth;
+
+        for ( int p = 0; p < poolCount; p++ ) {
+
+            begin = getMicrosecondsTimer();
+            findMatchGroupsTiled( pools[p], start, matches );
+            scanMicros[p + 1] += getMicrosecondsTimer() - begin;
+
+            if ( !equalsMatchList( matches, expectedMatches ) ) {
+                printf( "board %d: %d threads found different groups\n", b, pools[p]->threadCount );
+                same = false;
+            }
+
+            copyBoard( board, start );
+            Rng tiledRng = refill;
+            begin = getMicrosecondsTimer();
+            int tiledDepth = resolveTiledBoard( pools[p], scratch, board, &tiledRng, &cascade );
+            resolveMicros[p + 1] += getMicrosecondsTimer() - begin;
+
+            if ( tiledDepth != depth || cascade.hashDelta != hashDelta || !equalsBoard( board, expected ) ) {
+                printf( "board %d: %d threads resolved a different board\n", b, pools[p]->threadCount );
+                same = false;
+            }
+
+        }
+
+        // a reshuffle of the settled board, on its own stream so the boards
+        // do not depend on it
+        copyBoard( board, expected );
+        begin = getMicrosecondsTimer();
+        bool reshuffled = reshuffleBoard( board, &reshuffleRng );
+        uint64_t micros = getMicrosecondsTimer() - begin;
+        reshuffleMicros += micros;
+        worstReshuffleMicros = micros > worstReshuffleMicros ? micros : worstReshuffleMicros;
+
+        findMatchGroups( board, matches );
+        if ( !reshuffled || !samePiecesBoard( board, expected ) || matches->cellCount > 0 ) {
+            printf( "board %d: the reshuffle failed or left matches\n", b );
+            same = false;
+        }
+
+        // a single fall of the removed matches, compared column by column
+        copyBoard( expected, start );
+        for ( int k = 0; k < expectedMatches->cellCount; k++ ) {
+            setPieceBoard( expected, expectedMatches->cells[k].row, expectedMatches->cells[k].col, PIECE_NULL );
+        }
+        copyBoard( board, expected );
+        applyGravityBoard( expected, gravity );
+        int *fall = (int*) malloc( cellCount * sizeof( int ) );
+        memcpy( fall, gravity->fall, cellCount * sizeof( int ) );
+        applyGravityTiledBoard( pools[poolCount - 1], board, gravity );
+
+        if ( !equalsBoard( board, expected ) || memcmp( fall, gravity->fall, cellCount * sizeof( int ) ) != 0 ) {
+            printf( "board %d: the tiled gravity differs\n", b );
+            same = false;
+        }
+
+        free( fall );
+
+    }
+
+    printf( "%d boards of %d x %d, %.1f cascade steps per board\n", boards, width, height, (double) steps / boards );
+
+    for ( int p = 0; p <= poolCount; p++ ) {
+        double stepMicros = steps > 0 ? (double) resolveMicros[p] / steps : 0.0;
+        double speedup = resolveMicros[p] > 0 ? (double) resolveMicros[0] / resolveMicros[p] : 0.0;
+        if ( p == 0 ) {
+            printf( "serial     scan %10.1f us, cascade step %10.1f us\n", (double) scanMicros[p] / boards, stepMicros );
+        } else {
+            printf( "%2d threads scan %10.1f us, cascade step %10.1f us, %5.2fx serial\n",
+                    pools[p - 1]->threadCount, (double) scanMicros[p] / boards, stepMicros, speedup );
+        }
+    }
+
+    printf( "reshuffle  %.2f ms, worst %.2f ms\n", reshuffleMicros / 1000.0 / boards, worstReshuffleMicros / 1000.0 );
+    printf( "scratch arena high-water mark: %zu bytes\n", scratch->highWater );
+
+    for ( int p = 0; p < poolCount; p++ ) {
+        destroyThreadPool( pools[p] );
+    }
+
+    destroyBoard( start );
+    destroyBoard( expected );
+    destroyBoard( board );
+    destroyMatchList( expectedMatches );
+    destroyMatchList( matches );
+    destroyArena( scratch );
+    destroyGravity( gravity );
+
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}